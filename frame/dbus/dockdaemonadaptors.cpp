@@ -17,6 +17,10 @@ DockDaemonDBusAdaptor::DockDaemonDBusAdaptor(QObject *parent)
     connect(TaskManager::instance(), &TaskManager::frontendWindowRectChanged, this, &DockDaemonDBusAdaptor::FrontendWindowRectChanged);
     connect(TaskManager::instance(), &TaskManager::showRecentChanged, this, &DockDaemonDBusAdaptor::showRecentChanged);
     connect(TaskManager::instance(), &TaskManager::showMultiWindowChanged, this, &DockDaemonDBusAdaptor::ShowMultiWindowChanged);
+    connect(TaskManager::instance(), &TaskManager::windowInfoAdded, this, &DockDaemonDBusAdaptor::WindowInfoAdded);
+    connect(TaskManager::instance(), &TaskManager::windowInfoRemoved, this, &DockDaemonDBusAdaptor::WindowInfoRemoved);
+    connect(TaskManager::instance(), &TaskManager::windowTitleChanged, this, &DockDaemonDBusAdaptor::WindowTitleChanged);
+    connect(TaskManager::instance(), &TaskManager::windowAttentionChanged, this, &DockDaemonDBusAdaptor::WindowAttentionChanged);
 }
 
 DockDaemonDBusAdaptor::~DockDaemonDBusAdaptor()
@@ -96,6 +96,26 @@ class DockDaemonDBusAdaptor: public QDBusAbstractAdaptor
                                        "    <signal name=\"EntryRemoved\">\n"
                                        "      <arg type=\"s\" name=\"entryId\"/>\n"
                                        "    </signal>\n"
+                                       "    <signal name=\"WindowInfoAdded\">\n"
+                                       "      <arg type=\"s\" name=\"entryId\"/>\n"
+                                       "      <arg type=\"u\" name=\"win\"/>\n"
+                                       "      <arg type=\"s\" name=\"title\"/>\n"
+                                       "      <arg type=\"b\" name=\"attention\"/>\n"
+                                       "    </signal>\n"
+                                       "    <signal name=\"WindowInfoRemoved\">\n"
+                                       "      <arg type=\"s\" name=\"entryId\"/>\n"
+                                       "      <arg type=\"u\" name=\"win\"/>\n"
+                                       "    </signal>\n"
+                                       "    <signal name=\"WindowTitleChanged\">\n"
+                                       "      <arg type=\"s\" name=\"entryId\"/>\n"
+                                       "      <arg type=\"u\" name=\"win\"/>\n"
+                                       "      <arg type=\"s\" name=\"title\"/>\n"
+                                       "    </signal>\n"
+                                       "    <signal name=\"WindowAttentionChanged\">\n"
+                                       "      <arg type=\"s\" name=\"entryId\"/>\n"
+                                       "      <arg type=\"u\" name=\"win\"/>\n"
+                                       "      <arg type=\"b\" name=\"attention\"/>\n"
+                                       "    </signal>\n"
                                        "    <property access=\"readwrite\" type=\"u\" name=\"ShowTimeout\"/>\n"
                                        "    <property access=\"readwrite\" type=\"u\" name=\"HideTimeout\"/>\n"
                                        "    <property access=\"readwrite\" type=\"u\" name=\"WindowSizeEfficient\"/>\n"
@@ -185,6 +205,10 @@ Q_SIGNALS: // SIGNALS
     void ServiceRestarted();
     void EntryAdded(const Entry *entry, int index);
     void EntryRemoved(const QString &entryId);
+    void WindowInfoAdded(const QString &entryId, uint win, const QString &title, bool attention);
+    void WindowInfoRemoved(const QString &entryId, uint win);
+    void WindowTitleChanged(const QString &entryId, uint win, const QString &title);
+    void WindowAttentionChanged(const QString &entryId, uint win, bool attention);
 
     void DisplayModeChanged(int value) const;
     void DockedAppsChanged(const QStringList &value) const;
@@ -3,6 +3,9 @@
 #include "components/appsnapshot.h"
 #include "components/previewcontainer.h"
 #include "util/XUtils.h"
+#include "util/windowcapture.h"
+#include "util/windowdamagewatcher.h"
+#include "util/windowsnapshotservice.h"
 #include "xcb/xcb_misc.h"
 
 #include <dtkwidget_global.h>
@@ -12,100 +15,37 @@
 #include <X11/X.h>
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
-#include <sys/shm.h>
 #include <KWindowSystem>
 #include <QMouseEvent>
 #include <QDragEnterEvent>
 
-SHMInfo *getImageDSHM(WId wId)
-{
-    const auto display = QX11Info::display();
-
-    Atom atom_prop = XInternAtom(display, "_DEEPIN_DXCB_SHM_INFO", true);
-    if (!atom_prop) {
-        return nullptr;
-    }
-
-    Atom actual_type_return_deepin_shm;
-    int actual_format_return_deepin_shm;
-    unsigned long nitems_return_deepin_shm;
-    unsigned long bytes_after_return_deepin_shm;
-    unsigned char *prop_return_deepin_shm;
-
-    XGetWindowProperty(display, wId, atom_prop, 0, 32 * 9, false, AnyPropertyType,
-                    &actual_type_return_deepin_shm, &actual_format_return_deepin_shm, &nitems_return_deepin_shm,
-                    &bytes_after_return_deepin_shm, &prop_return_deepin_shm);
-
-    return reinterpret_cast<SHMInfo *>(prop_return_deepin_shm);
-}
-
-XImage *getImageXlib(WId wId)
-{
-    const auto display = QX11Info::display();
-    Window unused_window;
-    int unused_int;
-    unsigned unused_uint, w, h;
-    XGetGeometry(display, wId, &unused_window, &unused_int, &unused_int, &w, &h, &unused_uint, &unused_uint);
-    return XGetImage(display, wId, 0, 0, w, h, AllPlanes, ZPixmap);
-}
-
-QRect rectRemovedShadow(WId wId, const QImage &qimage, unsigned char *prop_to_return_gtk)
-{
-    const auto display = QX11Info::display();
-
-    const Atom gtk_frame_extents = XInternAtom(display, "_GTK_FRAME_EXTENTS", true);
-    Atom actual_type_return_gtk;
-    int actual_format_return_gtk;
-    unsigned long n_items_return_gtk;
-    unsigned long bytes_after_return_gtk;
-
-    const auto r = XGetWindowProperty(display, wId, gtk_frame_extents, 0, 4, false, XA_CARDINAL,
-                                    &actual_type_return_gtk, &actual_format_return_gtk, &n_items_return_gtk, &bytes_after_return_gtk, &prop_to_return_gtk);
-    if (!r && prop_to_return_gtk && n_items_return_gtk == 4 && actual_format_return_gtk == 32) {
-        qDebug() << "remove shadow frame...";
-        const unsigned long *extents = reinterpret_cast<const unsigned long *>(prop_to_return_gtk);
-        const int left = extents[0];
-        const int right = extents[1];
-        const int top = extents[2];
-        const int bottom = extents[3];
-        const int width = qimage.width();
-        const int height = qimage.height();
-
-        return QRect(left, top, width - left - right, height - top - bottom);
-    } else {
-        return QRect(0, 0, qimage.width(), qimage.height());
-    }
-}
-
-struct SHMInfo {
-    long shmid;
-    long width;
-    long height;
-    long bytesPerLine;
-    long format;
-
-    struct Rect {
-        long x;
-        long y;
-        long width;
-        long height;
-    } rect;
-};
-
 WindowItem::WindowItem(AppItem *appItem, WId wId, WindowInfo windowInfo, bool closeable, QWidget *parent) :
     DockItem(parent)
     , m_appItem(appItem)
     , m_WId(wId)
     , m_windowInfo(windowInfo)
     , m_closeable(closeable)
+    , m_snapshotWatcher(new QFutureWatcher<WindowThumbnail>(this))
+    , m_snapshotAcquired(false)
 {
     m_icon = m_appItem->appIcon();
 
+    connect(m_snapshotWatcher, &QFutureWatcher<WindowThumbnail>::finished, this, &WindowItem::onThumbnailReady);
+
+    // 支持XDamage时只在窗口重绘后刷新截图，并限制每个窗口的刷新频率；否则退回定时刷新
+    WindowDamageWatcher *damageWatcher = WindowDamageWatcher::instance();
     timer = new QTimer(this);
-    timer->setSingleShot(false);
-    timer->setInterval(10000);
+    timer->setSingleShot(damageWatcher->isAvailable());
+    timer->setInterval(damageWatcher->isAvailable() ? 1000 : 10000);
     connect(timer, &QTimer::timeout, this, &WindowItem::fetchSnapshot);
-    timer->start();
+    if (damageWatcher->isAvailable()) {
+        connect(damageWatcher, &WindowDamageWatcher::damaged, this, [this](WId wid) {
+            if (wid == m_WId && !timer->isActive())
+                timer->start();
+        });
+    } else {
+        timer->start();
+    }
 
     m_updateIconGeometryTimer = new QTimer(this);
     m_updateIconGeometryTimer->setInterval(500);
@@ -121,7 +61,11 @@ WindowItem::WindowItem(AppItem *appItem, WId wId, WindowInfo windowInfo, bool cl
     QTimer::singleShot(2000, this, &WindowItem::fetchSnapshot);
 }
 
-WindowItem::~WindowItem() {}
+WindowItem::~WindowItem()
+{
+    if (m_snapshotAcquired)
+        WindowSnapshotService::instance()->release(m_WId);
+}
 
 void WindowItem::paintEvent(QPaintEvent *e)
 {
@@ -153,6 +97,13 @@ void WindowItem::paintEvent(QPaintEvent *e)
     painter.drawPixmap(QPoint(itemRect.width() - smallIconSize - itemRect.width() * .1, itemRect.width() - smallIconSize - itemRect.width() * .1), m_icon.pixmap(smallIconSize));
 }
 
+QString WindowItem::paintKey() const
+{
+    const QRectF &r = m_snapshotSrcRect;
+    return DockItem::paintKey() + QString(":%1:%2,%3,%4,%5").arg(m_snapshot.cacheKey())
+            .arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height());
+}
+
 void WindowItem::mouseReleaseEvent(QMouseEvent *e)
 {
     if(e->button() == Qt::LeftButton) {
@@ -187,9 +138,15 @@ void WindowItem::resizeEvent(QResizeEvent *e)
 void WindowItem::enterEvent(QEvent *e)
 {
     DockItem::enterEvent(e);
+
+    // 窗口内容没有变化时沿用已有的截图
+    if (!m_snapshot.isNull() && !WindowDamageWatcher::instance()->isDamaged(m_WId))
+        return;
+
     timer->stop();
     fetchSnapshot();
-    timer->start();
+    if (!timer->isSingleShot())
+        timer->start();
 }
 
 void WindowItem::leaveEvent(QEvent *e)
@@ -264,7 +221,7 @@ void WindowItem::showPreview()
     QVector<uint> list;
     if(m_closeable)
         list.append(m_WId);
-    PreviewContainer *m_appPreview = PreviewContainer::instance(map, list, DockPosition);
+    PreviewContainer *m_appPreview = PreviewContainer::instance(map, list, DockPosition, popupScreen());
 
     connect(m_appPreview, &PreviewContainer::requestActivateWindow, m_appItem, &AppItem::requestActivateWindow, Qt::QueuedConnection);
     connect(m_appPreview, &PreviewContainer::requestPreviewWindow, m_appItem, &AppItem::requestPreviewWindow, Qt::QueuedConnection);
@@ -279,71 +236,60 @@ void WindowItem::fetchSnapshot()
 {
     if(this->window()->isVisible() == false) return;
 
-    QImage qimage;
-    SHMInfo *info = nullptr;
-    uchar *image_data = nullptr;
-    XImage *ximage = nullptr;
-    unsigned char *prop_to_return_gtk = nullptr;
-
-    do {
-        // get window image from shm(only for deepin app)
-        info = getImageDSHM(m_WId);
-        if (info) {
-            // qInfo() << "get Image from dxcbplugin SHM...";
-            //qDebug() << info->shmid << info->width << info->height << info->bytesPerLine << info->format << info->rect.x << info->rect.y << info->rect.width << info->rect.height;
-            image_data = (uchar *)shmat(info->shmid, 0, 0);
-            if ((qint64)image_data != -1) {
-                m_snapshot = QImage(image_data, info->width, info->height, info->bytesPerLine, (QImage::Format)info->format);
-                m_snapshotSrcRect = QRect(info->rect.x, info->rect.y, info->rect.width, info->rect.height);
-                break;
-            }
-            // qInfo() << "invalid pointer of shm!";
-            image_data = nullptr;
-        }
-
-        if (!image_data || qimage.isNull()) {
-            // get window image from XGetImage(a little slow)
-            // qInfo() << "get Image from dxcbplugin SHM failed!";
-            // qInfo() << "get Image from Xlib...";
-            ximage = getImageXlib(m_WId);
-            if (!ximage) {
-                // qInfo() << "get Image from Xlib failed! giving up...";
-                m_appItem->check();
-                return;
-            }
-            qimage = QImage((const uchar *)(ximage->data), ximage->width, ximage->height, ximage->bytes_per_line, QImage::Format_RGB32);
-        }
-
-        Q_ASSERT(!qimage.isNull());
-
-        // remove shadow frame
-        m_snapshotSrcRect = rectRemovedShadow(m_WId, qimage, prop_to_return_gtk);
-        m_snapshot = qimage;
-    } while (false);
-
-
-    QSizeF size(rect().marginsRemoved(QMargins(rect().width() * .1,  rect().height() * .1, rect().width() * .1, rect().height() * .1)).size());
-    const auto ratio = devicePixelRatioF();
-    size = m_snapshotSrcRect.size().scaled(size * ratio, Qt::KeepAspectRatio);
-
-    qreal scale = qreal(size.width()) / m_snapshotSrcRect.width();
-    m_snapshot = m_snapshot.scaled(qRound(m_snapshot.width() * scale), qRound(m_snapshot.height() * scale), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    // 截图与缩放由截图服务完成，窗口未重绘时直接复用与预览共享的截图
+    const QSizeF size(rect().marginsRemoved(QMargins(rect().width() * .1,  rect().height() * .1, rect().width() * .1, rect().height() * .1)).size());
+    const QFuture<WindowThumbnail> future = WindowSnapshotService::instance()->thumbnail(m_WId, size, devicePixelRatioF());
+    if (future.isCanceled()) {
+        m_appItem->check();
+        return;
+    }
 
-    m_snapshotSrcRect.moveTop(m_snapshotSrcRect.top() * scale + 0.5);
-    m_snapshotSrcRect.moveLeft(m_snapshotSrcRect.left() * scale + 0.5);
-    m_snapshotSrcRect.setWidth(size.width() - 0.5);
-    m_snapshotSrcRect.setHeight(size.height() - 0.5);
+    // 重新截图时旧的结果会被丢弃
+    m_snapshotWatcher->setFuture(future);
+}
 
-    m_snapshot.setDevicePixelRatio(ratio);
+void WindowItem::onThumbnailReady()
+{
+    const WindowThumbnail thumbnail = m_snapshotWatcher->result();
+    if (thumbnail.image.isNull())
+        return;
 
-    if (image_data) shmdt(image_data);
-    if (ximage) XDestroyImage(ximage);
-    if (info) XFree(info);
-    if (prop_to_return_gtk) XFree(prop_to_return_gtk);
+    m_snapshot = thumbnail.image;
+    m_snapshotSrcRect = thumbnail.rect;
 
     update();
 }
 
+void WindowItem::showEvent(QShowEvent *e)
+{
+    DockItem::showEvent(e);
+
+    if (!m_snapshotAcquired) {
+        m_snapshotAcquired = true;
+        WindowSnapshotService::instance()->acquire(m_WId);
+    }
+
+    // 隐藏期间的变化无从得知，显示后刷新一次
+    if (timer->isSingleShot())
+        timer->start();
+}
+
+void WindowItem::hideEvent(QHideEvent *e)
+{
+    DockItem::hideEvent(e);
+
+    // 任务栏隐藏后不再监听窗口变化
+    if (m_snapshotAcquired) {
+        m_snapshotAcquired = false;
+        WindowSnapshotService::instance()->release(m_WId);
+    }
+    if (timer->isSingleShot())
+        timer->stop();
+
+    // 截图服务返回的QFuture可能与预览共用，只断开监听而不取消
+    m_snapshotWatcher->setFuture(QFuture<WindowThumbnail>());
+}
+
 void WindowItem::invokedMenuItem(const QString &itemId, const bool checked) {
     if(itemId == "close")
         closeWindow();
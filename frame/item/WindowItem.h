@@ -4,6 +4,9 @@
 #include "dockitem.h"
 #include "appitem.h"
 #include "../taskmanager/windowinfomap.h"
+#include "../util/windowcapture.h"
+
+#include <QFutureWatcher>
 
 class AppItem;
 class WindowItem : public DockItem
@@ -14,7 +17,9 @@ class WindowItem : public DockItem
         explicit WindowItem(AppItem *appItem, WId wId, WindowInfo windowInfoBase, bool closeable, QWidget *parent=Q_NULLPTR);
         ~WindowItem();
         ItemType itemType() const override { return DockItem::Window; }
+        QString paintKey() const override;
         void fetchSnapshot();
+        void setWindowInfo(const WindowInfo &windowInfo) { m_windowInfo = windowInfo; }
 
     protected:
         void paintEvent(QPaintEvent *e) override;
@@ -24,6 +29,8 @@ class WindowItem : public DockItem
         void resizeEvent(QResizeEvent *e) override;
         void enterEvent(QEvent *e) override;
         void leaveEvent(QEvent *e) override;
+        void showEvent(QShowEvent *e) override;
+        void hideEvent(QHideEvent *e) override;
         void dragEnterEvent(QDragEnterEvent *e) override;
         void dragMoveEvent(QDragMoveEvent *e) override;
         void dropEvent(QDropEvent *e) override;
@@ -35,6 +42,7 @@ class WindowItem : public DockItem
         void showPreview();
         void showHoverTips() override;
         void closeWindow();
+        void onThumbnailReady();
 
     private:
         AppItem *m_appItem;
@@ -45,6 +53,8 @@ class WindowItem : public DockItem
         QRectF m_snapshotSrcRect;
         QTimer *timer;
         QTimer *m_updateIconGeometryTimer;
+        QFutureWatcher<WindowThumbnail> *m_snapshotWatcher;
+        bool m_snapshotAcquired;
 };
 
 #endif
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include "xcb/xcb_misc.h"
 #include "components/appeffect.h"
 #include "components/previewcontainer.h"
+#include "util/windowsnapshotservice.h"
 #include "../window/dockitemmanager.h"
 
 #include <X11/X.h>
@@ -38,38 +39,69 @@
 #include <DGuiApplicationHelper>
 #include <DPlatformTheme>
 
+namespace {
+// 所有AppItem共用同一套运行指示器，主题变化时只重新加载一次
+struct Indicators {
+    QPixmap horizontal;
+    QPixmap vertical;
+    QPixmap activeHorizontal;
+    QPixmap activeVertical;
+};
+
+const Indicators &indicators()
+{
+    static Indicators shared;
+    static bool initialized = false;
+    if (initialized)
+        return shared;
+
+    initialized = true;
+    auto themeChanged = [](DGuiApplicationHelper::ColorType type)
+    {
+        if (DGuiApplicationHelper::DarkType == type)
+        {
+            shared.horizontal = QPixmap(":/indicator/resources/indicator_dark.svg");
+            shared.vertical = QPixmap(":/indicator/resources/indicator_dark_ver.svg");
+        }
+        else
+        {
+            shared.horizontal = QPixmap(":/indicator/resources/indicator.svg");
+            shared.vertical = QPixmap(":/indicator/resources/indicator_ver.svg");
+        }
+    };
+    QObject::connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, themeChanged);
+    themeChanged(DGuiApplicationHelper::instance()->themeType());
+    shared.activeHorizontal = QPixmap(":/indicator/resources/indicator_active.svg");
+    shared.activeVertical = QPixmap(":/indicator/resources/indicator_active_ver.svg");
+
+    return shared;
+}
+}
+
 AppItem::AppItem(const Entry *entry, QWidget *parent) : DockItem(parent)
     , m_itemEntry(const_cast<Entry*>(entry))
     , m_isDocked(m_itemEntry->getIsDocked())
     , m_itemAnimation(nullptr)
     , m_updateIconGeometryTimer(nullptr)
     , m_dirItem(nullptr)
+    , m_prewarmTimer(new QTimer(this))
 {
     setAcceptDrops(true);
+    // 需要跟踪悬停时的鼠标移动来判断是否会打开预览
+    setMouseTracking(true);
+
+    m_prewarmTimer->setSingleShot(true);
+    m_prewarmTimer->setInterval(100);
+    connect(m_prewarmTimer, &QTimer::timeout, this, &AppItem::prewarmSnapshots);
 
     connect(m_itemEntry, &Entry::isActiveChanged, this, [this] { update(); });
-    connect(m_itemEntry, &Entry::windowInfosChanged, this, &AppItem::updateWindowInfos, Qt::QueuedConnection);
+    connect(m_itemEntry, &Entry::windowInfoAdded, this, &AppItem::onWindowInfoAdded, Qt::QueuedConnection);
+    connect(m_itemEntry, &Entry::windowInfoRemoved, this, &AppItem::onWindowInfoRemoved, Qt::QueuedConnection);
+    connect(m_itemEntry, &Entry::windowTitleChanged, this, &AppItem::onWindowTitleChanged, Qt::QueuedConnection);
+    connect(m_itemEntry, &Entry::windowAttentionChanged, this, &AppItem::onWindowAttentionChanged, Qt::QueuedConnection);
     connect(m_itemEntry, &Entry::iconChanged, this, &AppItem::refreshIcon);
     connect(this, &AppItem::requestPresentWindows, m_itemEntry, &Entry::presentWindows);
 
-    auto themeChanged = [this](DGuiApplicationHelper::ColorType type)
-    {
-        if (DGuiApplicationHelper::DarkType == type)
-        {
-            m_horizontalIndicator = QPixmap(":/indicator/resources/indicator_dark.svg");
-            m_verticalIndicator = QPixmap(":/indicator/resources/indicator_dark_ver.svg");
-        }
-        else
-        {
-            m_horizontalIndicator = QPixmap(":/indicator/resources/indicator.svg");
-            m_verticalIndicator = QPixmap(":/indicator/resources/indicator_ver.svg");
-        }
-    };
-    connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, themeChanged);
-    themeChanged(DGuiApplicationHelper::instance()->themeType());
-    m_activeHorizontalIndicator = QPixmap(":/indicator/resources/indicator_active.svg");
-    m_activeVerticalIndicator = QPixmap(":/indicator/resources/indicator_active_ver.svg");
-
     connect(DGuiApplicationHelper::instance()->systemTheme(), &DPlatformTheme::activeColorChanged, this, [this](const auto &color) { m_activeColor = color; });
 
 
@@ -82,6 +114,8 @@ AppItem::AppItem(const Entry *entry, QWidget *parent) : DockItem(parent)
 
 AppItem::~AppItem()
 {
+    cancelPrewarm();
+
     if(m_itemAnimation) {
         disconnect(m_itemAnimation, &QVariantAnimation::stateChanged, this, nullptr);
         m_itemAnimation->stop();
@@ -122,6 +156,7 @@ void AppItem::paintEvent(QPaintEvent *e)
 
     if (!m_windowInfos.isEmpty())
     {
+        const Indicators &indicator = indicators();
         QPoint p;
         QPixmap pixmap;
         QPixmap activePixmap;
@@ -132,20 +167,20 @@ void AppItem::paintEvent(QPaintEvent *e)
             {
             case Top:
             case Bottom:
-                pixmap = m_horizontalIndicator;
-                activePixmap = m_activeHorizontalIndicator;
+                pixmap = indicator.horizontal;
+                activePixmap = indicator.activeHorizontal;
                 p.setX((itemRect.width() - pixmap.width()) / 2);
                 p.setY(itemRect.height() - pixmap.height() - 1);
                 break;
             case Left:
-                pixmap = m_verticalIndicator;
-                activePixmap = m_activeVerticalIndicator;
+                pixmap = indicator.vertical;
+                activePixmap = indicator.activeVertical;
                 p.setX(1);
                 p.setY((itemRect.height() - pixmap.height()) / 2);
                 break;
             case Right:
-                pixmap = m_verticalIndicator;
-                activePixmap = m_activeVerticalIndicator;
+                pixmap = indicator.vertical;
+                activePixmap = indicator.activeVertical;
                 p.setX(itemRect.width() - pixmap.width() - 1);
                 p.setY((itemRect.height() - pixmap.height()) / 2);
                 break;
@@ -153,8 +188,8 @@ void AppItem::paintEvent(QPaintEvent *e)
         }
         else
         {
-            pixmap = m_horizontalIndicator;
-            activePixmap = m_activeHorizontalIndicator;
+            pixmap = indicator.horizontal;
+            activePixmap = indicator.activeHorizontal;
             p.setX((itemRect.width() - pixmap.width()) / 2);
             p.setY(itemRect.height() - pixmap.height() - 1);
         }
@@ -165,7 +200,16 @@ void AppItem::paintEvent(QPaintEvent *e)
             painter.drawPixmap(p, pixmap);
     }
 
-    painter.drawPixmap(appIconPosition(), m_icon.isNull() ? QPixmap(":/icons/resources/application-x-desktop.svg") : m_icon.pixmap(width() *.85).scaled(width() *.85, width() *.85));
+    painter.drawPixmap(appIconPosition(), iconPixmap());
+}
+
+QString AppItem::paintKey() const
+{
+    // 指示器随窗口数量、激活状态、任务栏方向与深浅色主题变化
+    return DockItem::paintKey() + QString(":%1:%2:%3:%4:%5:%6:%7").arg(iconPixmap().cacheKey())
+            .arg(m_windowInfos.isEmpty()).arg(m_itemEntry->getIsActive()).arg(m_place)
+            .arg(DockPosition).arg(m_itemAnimation != nullptr)
+            .arg(DGuiApplicationHelper::instance()->themeType());
 }
 
 void AppItem::mouseReleaseEvent(QMouseEvent *e)
@@ -246,22 +290,94 @@ void AppItem::dropEvent(QDropEvent *e)
     handleDragDrop(QX11Info::getTimestamp(), uriList);
 }
 
+void AppItem::enterEvent(QEvent *e)
+{
+    DockItem::enterEvent(e);
+
+    // 预览会在悬停500ms后弹出，鼠标在图标上稍作停留就提前截图
+    m_hoverTime.invalidate();
+    if (previewEnabled())
+        m_prewarmTimer->start();
+}
+
+void AppItem::mouseMoveEvent(QMouseEvent *e)
+{
+    DockItem::mouseMoveEvent(e);
+
+    if (!m_prewarmTimer->isActive())
+        return;
+
+    if (!m_hoverTime.isValid()) {
+        m_hoverTime.start();
+        m_hoverPos = e->globalPos();
+        return;
+    }
+
+    // 快速划过时重新计时，只有放慢下来才认为用户想看预览
+    const qint64 elapsed = qMax<qint64>(1, m_hoverTime.restart());
+    const int distance = (e->globalPos() - m_hoverPos).manhattanLength();
+    m_hoverPos = e->globalPos();
+    if (distance > elapsed / 2)
+        m_prewarmTimer->start();
+}
+
 void AppItem::leaveEvent(QEvent *e)
 {
     DockItem::leaveEvent(e);
 
+    cancelPrewarm();
+
     if (PreviewContainer::instance()->isVisible())
         PreviewContainer::instance()->prepareHide();
 }
 
 void AppItem::showHoverTips()
 {
-    if (m_place == DockItem::DockPlace and DockItemManager::instance()->getDockMergeMode() == MergeDock and !m_windowInfos.isEmpty())
+    if (previewEnabled())
         return showPreview();
 
     DockItem::showHoverTips();
 }
 
+bool AppItem::previewEnabled() const
+{
+    return m_place == DockItem::DockPlace and DockItemManager::instance()->getDockMergeMode() == MergeDock and !m_windowInfos.isEmpty();
+}
+
+/**
+ * @brief AppItem::prewarmSnapshots 按预览的默认大小提前生成各窗口的缩略图，预览弹出时可直接从截图服务中取到
+ */
+void AppItem::prewarmSnapshots()
+{
+    if (!previewEnabled() || !m_prewarmWindows.isEmpty() || !DWindowManagerHelper::instance()->hasComposite())
+        return;
+
+    WindowSnapshotService *service = WindowSnapshotService::instance();
+    const QSizeF size = AppSnapshot::defaultThumbnailSize();
+    // 预览只显示放得下的窗口，其余的滚动到时再截图
+    const bool horizontal = DockPosition == Top || DockPosition == Bottom;
+    const int count = PreviewContainer::visibleSnapshotCount(m_windowInfos.size(), horizontal ? Qt::Horizontal : Qt::Vertical, popupScreen());
+    for (auto it = m_windowInfos.cbegin(); it != m_windowInfos.cend() && m_prewarmWindows.size() < count; ++it) {
+        service->acquire(it.key());
+        m_prewarmWindows.append(it.key());
+        service->thumbnail(it.key(), size, devicePixelRatioF());
+    }
+}
+
+/**
+ * @brief AppItem::cancelPrewarm 鼠标离开后释放预取的窗口，尚未完成的缩略图不再写入缓存
+ */
+void AppItem::cancelPrewarm()
+{
+    m_prewarmTimer->stop();
+    m_hoverTime.invalidate();
+
+    WindowSnapshotService *service = WindowSnapshotService::instance();
+    for (WId wid : m_prewarmWindows)
+        service->release(wid);
+    m_prewarmWindows.clear();
+}
+
 void AppItem::invokedMenuItem(const QString &itemId, const bool checked)
 {
     Q_UNUSED(checked);
@@ -300,13 +416,24 @@ QPoint AppItem::appIconPosition() const
 {
     const auto ratio = devicePixelRatioF();
     const QRectF itemRect = rect();
-    const QRectF iconRect = m_icon.pixmap(width()*.85).rect();
+    iconPixmap();
+    const QRectF iconRect = m_iconPixmap.sourceRect();
     const qreal iconX = itemRect.center().x() - iconRect.center().x() / ratio;
     const qreal iconY = itemRect.center().y() - iconRect.center().y() / ratio;
 
     return QPoint(iconX, iconY);
 }
 
+/**
+ * @brief AppItem::iconPixmap 图标按当前尺寸与缩放比只渲染一次，图标、尺寸或屏幕缩放变化时才重新生成，
+ * 悬停动画等频繁重绘时只需直接绘制
+ * @return
+ */
+const QPixmap &AppItem::iconPixmap() const
+{
+    return m_iconPixmap.pixmap(m_icon, int(width() * .85), devicePixelRatioF());
+}
+
 void AppItem::updateWindowInfos(const WindowInfoMap &info)
 {
     m_windowInfos = info;
@@ -314,13 +441,7 @@ void AppItem::updateWindowInfos(const WindowInfoMap &info)
     if(m_updateIconGeometryTimer)
         m_updateIconGeometryTimer->start();
 
-    // process attention effect
-    if (hasAttention()) {
-        if(m_place == DockItem::DockPlace)
-            playSwingEffect();
-    } else if(m_place == DockItem::DirPlace and m_itemAnimation)
-        m_itemAnimation->stop();
-
+    updateAttentionEffect();
     update();
 
     if (DockItemManager::instance()->getDockMergeMode() == MergeDock && m_place == DockPlace)
@@ -328,7 +449,7 @@ void AppItem::updateWindowInfos(const WindowInfoMap &info)
 
     for (auto it(m_windowMap.begin()); it != m_windowMap.end();)
     {
-        if (!m_windowInfos.keys().contains(it.key()))
+        if (!m_windowInfos.contains(it.key()))
         {
             WindowItem *windowItem = it.value();
             it = m_windowMap.erase(it);
@@ -341,15 +462,91 @@ void AppItem::updateWindowInfos(const WindowInfoMap &info)
     }
 
     for (auto it(m_windowInfos.cbegin()); it != m_windowInfos.cend(); it++)
-    {
-        if (!m_windowMap.contains(it.key()))
-        {
-            WindowItem *windowItem = new WindowItem(this, it.key(), it.value(), m_itemEntry->getAllowedClosedWindowIds().contains(it.key()));
-            m_windowMap.insert(it.key(), windowItem);
-            emit windowItemInserted(windowItem);
-            windowItem->fetchSnapshot();
-        }
-    }
+        insertWindowItem(it.key(), it.value());
+}
+
+void AppItem::onWindowInfoAdded(quint32 xid, const WindowInfo &info)
+{
+    m_windowInfos.insert(xid, info);
+
+    if(m_updateIconGeometryTimer)
+        m_updateIconGeometryTimer->start();
+
+    updateAttentionEffect();
+    update();
+
+    if (DockItemManager::instance()->getDockMergeMode() == MergeDock && m_place == DockPlace)
+        return;
+
+    insertWindowItem(xid, info);
+}
+
+void AppItem::onWindowInfoRemoved(quint32 xid)
+{
+    if (!m_windowInfos.remove(xid))
+        return;
+
+    if(m_updateIconGeometryTimer)
+        m_updateIconGeometryTimer->start();
+
+    updateAttentionEffect();
+    update();
+
+    PreviewContainer::instance()->removeWindowInfo(xid);
+
+    if (m_windowMap.contains(xid))
+        emit windowItemRemoved(m_windowMap.take(xid));
+}
+
+void AppItem::onWindowTitleChanged(quint32 xid, const QString &title)
+{
+    auto it = m_windowInfos.find(xid);
+    if (it == m_windowInfos.end())
+        return;
+
+    it->title = title;
+
+    // 标题变化不影响图标绘制，只同步给窗口项和预览
+    if (m_windowMap.contains(xid))
+        m_windowMap[xid]->setWindowInfo(it.value());
+    PreviewContainer::instance()->updateWindowInfo(xid, it.value());
+}
+
+void AppItem::onWindowAttentionChanged(quint32 xid, bool attention)
+{
+    auto it = m_windowInfos.find(xid);
+    if (it == m_windowInfos.end())
+        return;
+
+    it->attention = attention;
+
+    if (m_windowMap.contains(xid))
+        m_windowMap[xid]->setWindowInfo(it.value());
+    PreviewContainer::instance()->updateWindowInfo(xid, it.value());
+
+    updateAttentionEffect();
+    update();
+}
+
+void AppItem::updateAttentionEffect()
+{
+    // process attention effect
+    if (hasAttention()) {
+        if(m_place == DockItem::DockPlace)
+            playSwingEffect();
+    } else if(m_place == DockItem::DirPlace and m_itemAnimation)
+        m_itemAnimation->stop();
+}
+
+void AppItem::insertWindowItem(quint32 xid, const WindowInfo &info)
+{
+    if (m_windowMap.contains(xid))
+        return;
+
+    WindowItem *windowItem = new WindowItem(this, xid, info, m_itemEntry->getAllowedClosedWindowIds().contains(xid));
+    m_windowMap.insert(xid, windowItem);
+    emit windowItemInserted(windowItem);
+    windowItem->fetchSnapshot();
 }
 
 void AppItem::mergeModeChanged(MergeMode mode)
@@ -382,15 +579,7 @@ void AppItem::mergeModeChanged(MergeMode mode)
             m_updateIconGeometryTimer = nullptr;
         }
         for (auto it(m_windowInfos.cbegin()); it != m_windowInfos.cend(); it++)
-        {
-            if (!m_windowMap.contains(it.key()))
-            {
-                WindowItem *windowItem = new WindowItem(this, it.key(), it.value(), m_itemEntry->getAllowedClosedWindowIds().contains(it.key()));
-                m_windowMap.insert(it.key(), windowItem);
-                emit windowItemInserted(windowItem);
-                windowItem->fetchSnapshot();
-            }
-        }
+            insertWindowItem(it.key(), it.value());
     }
 }
 
@@ -406,9 +595,18 @@ void AppItem::removeWindowItem(bool animation)
 
 void AppItem::refreshIcon()
 {
-    const QString icon = m_itemEntry->getIcon();
-    m_icon.addPixmap(Utils::getIcon(icon, 100 * 0.85, devicePixelRatioF()));
+    // 窗口图标直接使用原始像素，避免PNG/base64编解码
+    const WindowIcon windowIcon = m_itemEntry->getWindowIcon();
+    if (!windowIcon.isNull())
+        m_icon = QIcon(Utils::getIcon(windowIcon.image, windowIcon.key, 100 * 0.85, devicePixelRatioF()));
+    else
+        m_icon = QIcon(Utils::getIcon(m_itemEntry->getIcon(), 100 * 0.85, devicePixelRatioF()));
+    m_iconPixmap.clear();
     update();
+
+    // 所在集合的图标由成员的图标拼成
+    if (m_dirItem)
+        m_dirItem->update();
 }
 
 void AppItem::requestActivateWindow(const WId wid) {
@@ -419,7 +617,7 @@ void AppItem::showPreview()
 {
     if (m_windowInfos.isEmpty()) return;
 
-    PreviewContainer *m_appPreviewTips = PreviewContainer::instance(m_windowInfos, m_itemEntry->getAllowedClosedWindowIds(), DockPosition);
+    PreviewContainer *m_appPreviewTips = PreviewContainer::instance(m_windowInfos, m_itemEntry->getAllowedClosedWindowIds(), DockPosition, popupScreen());
 
     connect(m_appPreviewTips, &PreviewContainer::requestActivateWindow, this, &AppItem::requestActivateWindow, Qt::QueuedConnection);
     connect(m_appPreviewTips, &PreviewContainer::requestPreviewWindow, this, &AppItem::requestPreviewWindow, Qt::QueuedConnection);
@@ -435,8 +633,10 @@ void AppItem::playSwingEffect()
     const DockItemManager::ActivateAnimationType type = DockItemManager::instance()->animationType();
     if (type == DockItemManager::No || m_itemAnimation) return;
 
-    m_itemAnimation = type == DockItemManager::Swing ? AppEffect::SwingEffect(this, m_icon.pixmap(width() *.85))
-        : AppEffect::JumpEffect(this, m_icon.pixmap(width() *.85), m_place == DirPlace ? Bottom : DockPosition);
+    const QPixmap icon = m_icon.pixmap(width() * .85);
+    const QString cacheKey = AppEffect::iconKey(m_icon, icon);
+    m_itemAnimation = type == DockItemManager::Swing ? AppEffect::SwingEffect(this, icon, cacheKey)
+        : AppEffect::JumpEffect(this, icon, m_place == DirPlace ? Bottom : DockPosition, cacheKey);
 
     connect(m_itemAnimation, &QVariantAnimation::stateChanged, this, [this](const QVariantAnimation::State &newState, const QVariantAnimation::State &oldState) {
         if (newState == QVariantAnimation::Stopped) {
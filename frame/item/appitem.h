@@ -27,9 +27,12 @@
 #include "diritem.h"
 #include "WindowItem.h"
 #include "../taskmanager/entry.h"
+#include "components/iconpixmap.h"
 
 #include <DGuiApplicationHelper>
 
+#include <QElapsedTimer>
+
 class DirItem;
 class WindowItem;
 class AppItem : public DockItem
@@ -51,8 +54,14 @@ public:
     inline QPixmap appIcon() const {
         return m_icon.isNull() ? QPixmap(":/icons/resources/application-x-desktop.svg") : m_icon.pixmap(width()*.9);
     }
+    // 图标更换后cacheKey改变，集合据此判断合成图是否过期
+    inline const QIcon &icon() const { return m_icon; }
     QString getDesktopFile() const { return m_itemEntry->getDesktopFile(); }
+    QString iconName() const { return m_itemEntry->getIcon(); }
+    // 使用窗口自带的图标时不经过图标主题
+    bool hasWindowIcon() const { return !m_itemEntry->getWindowIcon().isNull(); }
     Place getPlace() override { return m_place; }
+    QString paintKey() const override;
     DirItem *getDirItem() { return m_dirItem; }
     void setDirItem(DirItem *dirItem);
     void removeDirItem();
@@ -84,6 +93,8 @@ private:
     void dragEnterEvent(QDragEnterEvent *e) override;
     void dragMoveEvent(QDragMoveEvent *e) override;
     void dropEvent(QDropEvent *e) override;
+    void enterEvent(QEvent *e) override;
+    void mouseMoveEvent(QMouseEvent *e) override;
     void leaveEvent(QEvent *e) override;
 
     void showHoverTips() Q_DECL_OVERRIDE;
@@ -92,11 +103,21 @@ private:
     QString popupTips() Q_DECL_OVERRIDE;
     const QPoint popupMarkPoint() override;
     bool hasAttention() const;
+    void updateAttentionEffect();
+    void insertWindowItem(quint32 xid, const WindowInfo &info);
+    bool previewEnabled() const;
+    void prewarmSnapshots();
+    void cancelPrewarm();
 
     QPoint appIconPosition() const;
+    const QPixmap &iconPixmap() const;
 
 private slots:
     void updateWindowInfos(const WindowInfoMap &info);
+    void onWindowInfoAdded(quint32 xid, const WindowInfo &info);
+    void onWindowInfoRemoved(quint32 xid);
+    void onWindowTitleChanged(quint32 xid, const QString &title);
+    void onWindowAttentionChanged(quint32 xid, bool attention);
     void mergeModeChanged(MergeMode mode);
     void showPreview();
     void playSwingEffect();
@@ -112,11 +133,14 @@ private:
     DirItem *m_dirItem;
     QMap<WId, WindowItem *> m_windowMap;
 
+    mutable IconPixmap m_iconPixmap;    // 按当前尺寸与缩放比预先渲染的图标
+
     QColor m_activeColor;
-    QPixmap m_horizontalIndicator;
-    QPixmap m_verticalIndicator;
-    QPixmap m_activeHorizontalIndicator;
-    QPixmap m_activeVerticalIndicator;
+
+    QTimer *m_prewarmTimer;             // 悬停停留后提前截取预览
+    QPoint m_hoverPos;
+    QElapsedTimer m_hoverTime;
+    QList<WId> m_prewarmWindows;
 };
 
 #endif // APPITEM_H
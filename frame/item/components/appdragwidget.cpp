@@ -23,6 +23,9 @@
 
 #include "../appitem.h"
 #include "../diritem.h"
+#include "util/frameclock.h"
+
+#include <QApplication>
 
 class AppGraphicsObject : public QGraphicsObject
 {
@@ -64,12 +67,13 @@ private:
 AppDragWidget::AppDragWidget(QWidget *parent) : QGraphicsView(parent),
     m_object(new AppGraphicsObject),
     m_scene(new QGraphicsScene(this)),
-    m_followMouseTimer(new QTimer(this)),
     m_animScale(new QPropertyAnimation(m_object, "scale", this)),
     m_animRotation(new QPropertyAnimation(m_object, "rotation", this)),
     m_animOpacity(new QPropertyAnimation(m_object, "opacity", this)),
     m_animGroup(new QParallelAnimationGroup(this)),
-    m_goBackAnim(new QPropertyAnimation(this, "pos", this))
+    m_goBackAnim(new QPropertyAnimation(this, "pos", this)),
+    m_following(true),
+    m_pollPointer(true)
 {
     m_scene->addItem(m_object);
     setScene(m_scene);
@@ -85,19 +89,43 @@ AppDragWidget::AppDragWidget(QWidget *parent) : QGraphicsView(parent),
     setAcceptDrops(true);
     initAnimations();
 
-    m_followMouseTimer->setSingleShot(false);
-    m_followMouseTimer->setInterval(1);
-    connect(m_followMouseTimer, &QTimer::timeout, [this] {
-        QPoint destPos = QCursor::pos();
-        move(destPos.x() - width() / 2, destPos.y() - height() / 2);
-    });
-    m_followMouseTimer->start();
+    // 拖拽期间窗口位于光标下方，光标位置由拖拽事件给出，不再定时查询
+    qApp->installEventFilter(this);
 }
 
 AppDragWidget::~AppDragWidget() {
     m_object->deleteLater();
 }
 
+bool AppDragWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    if (!m_following)
+        return QGraphicsView::eventFilter(watched, event);
+
+    switch (event->type()) {
+    case QEvent::DragEnter:
+    case QEvent::DragMove: {
+        // 任务栏中任意控件收到的拖拽事件都带有光标位置
+        QWidget *widget = qobject_cast<QWidget *>(watched);
+        if (widget)
+            followPointer(widget->mapToGlobal(static_cast<QDropEvent *>(event)->pos()));
+        break;
+    }
+    case QEvent::DragLeave:
+        // 光标一次移动过远离开了本窗口，落到其他程序的窗口上时收不到拖拽事件，改为每帧查询一次光标位置。
+        // QGraphicsView的拖拽事件发给viewport而不是视图本身
+        if (watched == viewport() && !m_pollPointer) {
+            m_pollPointer = true;
+            pollPointer();
+        }
+        break;
+    default:
+        break;
+    }
+
+    return QGraphicsView::eventFilter(watched, event);
+}
+
 void AppDragWidget::mouseMoveEvent(QMouseEvent *event)
 {
     QGraphicsView::mouseMoveEvent(event);
@@ -124,7 +152,8 @@ void AppDragWidget::dragMoveEvent(QDragMoveEvent *event)
 
 void AppDragWidget::dropEvent(QDropEvent *event)
 {
-    m_followMouseTimer->stop();
+    m_pointerPos = mapToGlobal(event->pos());
+    stopFollowing();
     AppItem *appItem = qobject_cast<AppItem *>(event->source());
 
     if (appItem && isRemoveAble()) {
@@ -136,8 +165,19 @@ void AppDragWidget::dropEvent(QDropEvent *event)
     }
 }
 
+void AppDragWidget::showEvent(QShowEvent *event)
+{
+    QGraphicsView::showEvent(event);
+
+    // 第一个拖拽事件到达前从光标当前位置开始跟随
+    if (m_following && m_pollPointer)
+        pollPointer();
+}
+
 void AppDragWidget::hideEvent(QHideEvent *event)
 {
+    // 放下事件可能被任务栏拦截，隐藏时同样停止跟随
+    stopFollowing();
     deleteLater();
 }
 
@@ -200,9 +240,51 @@ void AppDragWidget::showGoBackAnimation()
     m_goBackAnim->start();
 }
 
+/**
+ * @brief AppDragWidget::followPointer 记录最新的光标位置，同一帧内的多次移动只移动一次窗口
+ */
+void AppDragWidget::followPointer(const QPoint &pos)
+{
+    m_pointerPos = pos;
+    m_pollPointer = false;
+
+    FrameClock::instance()->requestFrame(this, [this] {
+        if (m_following)
+            move(m_pointerPos - QPoint(width() / 2, height() / 2));
+    });
+}
+
+/**
+ * @brief AppDragWidget::pollPointer 收不到拖拽事件时每帧查询一次光标位置，直到拖拽事件恢复
+ */
+void AppDragWidget::pollPointer()
+{
+    FrameClock::instance()->requestFrame(this, [this] {
+        if (!m_following || !m_pollPointer)
+            return;
+
+        m_pointerPos = QCursor::pos();
+        move(m_pointerPos - QPoint(width() / 2, height() / 2));
+        pollPointer();
+    });
+}
+
+/**
+ * @brief AppDragWidget::stopFollowing 拖拽结束后不再跟随光标，同时移除全局事件过滤器
+ */
+void AppDragWidget::stopFollowing()
+{
+    if (!m_following)
+        return;
+
+    m_following = false;
+    m_pollPointer = false;
+    qApp->removeEventFilter(this);
+}
+
 bool AppDragWidget::isRemoveAble()
 {
-    const QPoint &p = QCursor::pos();
+    const QPoint &p = m_pointerPos;
     switch (m_dockPosition) {
         case Dock::Position::Left:
             if ((p.x() - m_dockGeometry.topRight().x()) > (m_dockGeometry.width() * 3)) {
@@ -29,7 +29,6 @@
 #include <QGraphicsView>
 #include <QPainter>
 #include <QMouseEvent>
-#include <QTimer>
 #include <QPropertyAnimation>
 #include <QParallelAnimationGroup>
 #include <qwidget.h>
@@ -48,16 +47,21 @@ public:
     bool isRemoveAble();
 
 protected:
+    bool eventFilter(QObject *watched, QEvent *event) Q_DECL_OVERRIDE;
     void mouseMoveEvent(QMouseEvent *event) Q_DECL_OVERRIDE;
     void dragEnterEvent(QDragEnterEvent *event) Q_DECL_OVERRIDE;
     void dragMoveEvent(QDragMoveEvent *event) Q_DECL_OVERRIDE;
     void dropEvent(QDropEvent *event) Q_DECL_OVERRIDE;
+    void showEvent(QShowEvent *event) Q_DECL_OVERRIDE;
     void hideEvent(QHideEvent *event) Q_DECL_OVERRIDE;
 
 private:
     void initAnimations();
     void showRemoveAnimation();
     void showGoBackAnimation();
+    void followPointer(const QPoint &pos);
+    void pollPointer();
+    void stopFollowing();
 
 signals:
     void finished(bool undock);
@@ -65,7 +69,6 @@ signals:
 private:
     AppGraphicsObject *m_object;
     QGraphicsScene *m_scene;
-    QTimer *m_followMouseTimer;
     QPropertyAnimation *m_animScale;
     QPropertyAnimation *m_animRotation;
     QPropertyAnimation *m_animOpacity;
@@ -75,6 +78,9 @@ private:
     Dock::Position m_dockPosition;
     QRect m_dockGeometry;
     QPoint m_originPoint;
+    QPoint m_pointerPos;        // 最近一次得到的光标位置
+    bool m_following;           // 放下之后不再跟随光标
+    bool m_pollPointer;         // 暂时收不到拖拽事件，需要每帧查询光标位置
 };
 
 #endif /* APPDRAGWIDGET_H */
@@ -2,6 +2,11 @@
 
 #include "util/utils.h"
 
+#include <QLoggingCategory>
+#include <QPixmapCache>
+
+Q_LOGGING_CATEGORY(effectLog, "dde.dock.effect", QtInfoMsg)
+
 const static qreal Frames[] = { 0,
                                 0.327013,
                                 0.987033,
@@ -63,17 +68,48 @@ const static qreal Frames[] = { 0,
                                 0,
                             };
 
-AppEffect::AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::ActivateAnimationType type, Position position) : QGraphicsView()
-    , m_parent(parent)
-    , m_icon(icon)
-    , m_position(position)
-    , m_type(type){
+namespace {
+// 提亮后的图标按图标内容缓存，连续播放动画时不必每次重新处理像素。没有标识的图片每次都是新的，缓存了也不会再命中
+QPixmap lighterIcon(const QPixmap &icon, const QString &cacheKey)
+{
+    if (cacheKey.isEmpty())
+        return Utils::lighterEffect(icon);
+
+    const QString key = QString("app-effect-lighter-%1").arg(cacheKey);
+    QPixmap pixmap;
+    if (!QPixmapCache::find(key, &pixmap)) {
+        pixmap = Utils::lighterEffect(icon);
+        QPixmapCache::insert(key, pixmap);
+    }
+
+    return pixmap;
+}
+}
+
+EffectOverlay *EffectOverlay::instance(bool below)
+{
+    static EffectOverlay *overlay = nullptr;
+    static EffectOverlay *belowOverlay = nullptr;
+
+    EffectOverlay *&instance = below ? belowOverlay : overlay;
+    if (!instance) {
+        instance = new EffectOverlay(below);
+        qCDebug(effectLog) << "overlay window created, below:" << below;
+    }
+
+    return instance;
+}
+
+EffectOverlay::EffectOverlay(bool below) : QGraphicsView()
+    , m_below(below)
+{
     setWindowFlags(Qt::X11BypassWindowManagerHint | Qt::WindowStaysOnTopHint | Qt::WindowDoesNotAcceptFocus);
+    setWindowFlag(Qt::WindowStaysOnBottomHint, below);
     setAttribute(Qt::WA_TransparentForMouseEvents);
     setAttribute( Qt::WA_TranslucentBackground);
     viewport()->setAutoFillBackground(false);
     setFrameShape(QFrame::NoFrame);
-    setAlignment(Qt::AlignCenter);
+    setAlignment(Qt::AlignLeft | Qt::AlignTop);
     setFrameStyle(QFrame::NoFrame);
     setContentsMargins(0, 0, 0, 0);
     setRenderHints(QPainter::SmoothPixmapTransform);
@@ -81,19 +117,74 @@ AppEffect::AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::Acti
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
     setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 
-    m_itemScene = new QGraphicsScene(this);
-    setScene(m_itemScene);
+    setScene(new QGraphicsScene(this));
+}
+
+void EffectOverlay::fitToEffects()
+{
+    QRectF rect;
+    for (QGraphicsItem *item : scene()->items()) {
+        if (!item->parentItem() && item->isVisible())
+            rect |= item->sceneBoundingRect();
+    }
+
+    if (rect.isEmpty()) {
+        hide();
+        return;
+    }
+
+    const QRect geometry = rect.toAlignedRect();
+    setSceneRect(geometry);
+    setFixedSize(geometry.size());
+    move(geometry.topLeft());
+    show();
 
-    m_item = m_itemScene->addPixmap(Utils::lighterEffect(m_icon));
+    // 窗口复用后不会因重新映射而回到最上层，需要主动提升
+    if (!m_below)
+        raise();
+}
+
+QString AppEffect::iconKey(const QIcon &icon, const QPixmap &pixmap)
+{
+    if (icon.isNull())
+        return QString();
+
+    // 主题图标切换图标主题后cacheKey不变，内容却变了
+    return QString("%1:%2:%3x%4").arg(QIcon::themeName()).arg(icon.cacheKey()).arg(pixmap.width()).arg(pixmap.height());
+}
+
+AppEffect::AppEffect(QWidget *parent, const QPixmap &icon, const QString &cacheKey, DockItemManager::ActivateAnimationType type, Position position) : QObject(parent)
+    , m_parent(parent)
+    , m_icon(icon)
+    , m_position(position)
+    , m_type(type)
+    , m_overlay(EffectOverlay::instance(type == DockItemManager::Popup))
+    , m_frameCount(0)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_frame = m_overlay->scene()->addRect(QRectF(), Qt::NoPen);
+    m_frame->setFlag(QGraphicsItem::ItemClipsChildrenToShape);
+    m_frame->setVisible(false);
+
+    m_item = new QGraphicsPixmapItem(lighterIcon(m_icon, cacheKey), m_frame);
     m_item->setTransformationMode(Qt::SmoothTransformation);
 
     m_animation = new QVariantAnimation(this);
     m_animation->setDuration(1200);
     m_animation->setLoopCount(1);
+    connect(m_animation, &QVariantAnimation::valueChanged, this, [this] { ++m_frameCount; });
     connect(m_animation, &QVariantAnimation::stateChanged, this, [this](QVariantAnimation::State newState, QVariantAnimation::State oldState) {
-        if(newState == QVariantAnimation::Running)
-            show();
-        else if (newState == QVariantAnimation::Stopped) {
+        if(newState == QVariantAnimation::Running) {
+            m_frame->setVisible(true);
+            m_overlay->fitToEffects();
+            m_frameCount = 0;
+            m_runningTimer.start();
+        } else if (newState == QVariantAnimation::Stopped) {
+            const qint64 elapsed = m_runningTimer.elapsed();
+            qCDebug(effectLog) << "effect" << m_type << "finished," << m_frameCount << "frames in" << elapsed << "ms, average frame time"
+                               << (m_frameCount > 0 ? qreal(elapsed) / m_frameCount : 0.) << "ms";
             if(m_type != DockItemManager::Popup or m_animation->direction() == QVariantAnimation::Backward)
                 deleteLater();
         }
@@ -107,17 +198,24 @@ AppEffect::AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::Acti
         initScale();
     else
         initPopup();
+
+    qCDebug(effectLog) << "effect" << type << "created in" << timer.nsecsElapsed() / 1000 << "us, cached icon:" << !cacheKey.isEmpty();
+}
+
+AppEffect::~AppEffect()
+{
+    // 图标项随区域一起从共用的场景中移除
+    delete m_frame;
+    m_overlay->fitToEffects();
 }
 
 void AppEffect::initSwing() {
-    move(m_parent->mapToGlobal(QPoint(0, 0)));
+    m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)));
 
     m_item->setPos(QPointF(m_parent->rect().center()) - QPointF(m_icon.rect().center()) / m_parent->devicePixelRatioF());
     m_item->setTransformOriginPoint(m_parent->rect().center() + QPoint(0, 18));
 
-    m_itemScene->setSceneRect(m_parent->rect());
-    setSceneRect(m_parent->rect());
-    setFixedSize(m_parent->rect().size());
+    m_frame->setRect(m_parent->rect());
 
     m_animation->setEasingCurve(QEasingCurve::Linear);
     connect(m_animation, &QVariantAnimation::valueChanged, [this](const QVariant &value){
@@ -139,9 +237,7 @@ void AppEffect::initJump() {
     else
         height *= 2;
 
-    m_itemScene->setSceneRect(0, 0, width, height);
-    setSceneRect(0, 0, width, height);
-    setFixedSize(QSize(width, height));
+    m_frame->setRect(0, 0, width, height);
 
     m_animation->setEasingCurve(QEasingCurve::OutBounce);
     connect(m_animation, &QVariantAnimation::valueChanged, [this](const QVariant &value){
@@ -163,18 +259,17 @@ void AppEffect::initJump() {
     }
 
     if (m_position == Bottom)
-        move(m_parent->mapToGlobal(QPoint(0, 0)) - QPoint{0, this->height()-m_parent->height()});
+        m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)) - QPoint{0, height-m_parent->height()});
     else if (m_position == Right)
-        move(m_parent->mapToGlobal(QPoint(0, 0)) - QPoint{this->width()-m_parent->width(), 0});
+        m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)) - QPoint{width-m_parent->width(), 0});
     else if(m_position == Left)
-        move(m_parent->mapToGlobal(QPoint(0, 0)));
+        m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)));
 }
 
 void AppEffect::initScale() {
     m_parent->installEventFilter(this);
-    move(m_parent->mapToGlobal(QPoint(0, 0)));
-    m_itemScene->setSceneRect(m_parent->rect());
-    setFixedSize(m_parent->rect().size());
+    m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)));
+    m_frame->setRect(m_parent->rect());
 
     m_item->setPos(QPointF(m_parent->rect().center()) - QPointF(m_icon.rect().center()) / m_parent->devicePixelRatioF());
     m_item->setTransformOriginPoint(m_parent->rect().center());
@@ -190,27 +285,22 @@ void AppEffect::initScale() {
 }
 
 void AppEffect::initPopup() {
-    setWindowFlag(Qt::WindowStaysOnBottomHint, true);
-
     const qreal scale = .2;
     const int oldWidth = m_parent->width();
     const int newWidth = oldWidth*(1 + scale);
     QPointF pos = m_parent->rect().center() - m_icon.rect().center() / m_parent->devicePixelRatioF();
 
     if (m_position == Bottom) {
-        m_itemScene->setSceneRect(0, 0, oldWidth, newWidth);
-        setFixedSize(QSize(oldWidth, newWidth));
-        move(m_parent->mapToGlobal(QPoint(0, 0)) - QPoint(0, oldWidth*scale));
+        m_frame->setRect(0, 0, oldWidth, newWidth);
+        m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)) - QPoint(0, oldWidth*scale));
         m_item->setPos(QPoint(0, newWidth) + QPoint(pos.x(), -pos.y() - m_icon.height()/m_parent->devicePixelRatioF()));
     } else if (m_position == Right) {
-        m_itemScene->setSceneRect(0, 0, newWidth, oldWidth);
-        setFixedSize(QSize(newWidth, oldWidth));
-        move(m_parent->mapToGlobal(QPoint(0, 0)) - QPoint(oldWidth*scale, 0));
+        m_frame->setRect(0, 0, newWidth, oldWidth);
+        m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)) - QPoint(oldWidth*scale, 0));
         m_item->setPos(QPoint(newWidth, 0) + QPoint(-pos.x() - m_icon.width()/m_parent->devicePixelRatioF(), pos.y()));
     } else if(m_position == Left) {
-        m_itemScene->setSceneRect(0, 0, newWidth, oldWidth);
-        setFixedSize(QSize(newWidth, oldWidth));
-        move(m_parent->mapToGlobal(QPoint(0, 0)));
+        m_frame->setRect(0, 0, newWidth, oldWidth);
+        m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)));
         m_item->setPos(pos);
     }
 
@@ -231,22 +321,11 @@ void AppEffect::initPopup() {
     m_animation->setEndValue(oldWidth*scale);
 }
 
-void AppEffect::enterEvent(QEvent *event) {
-    QGraphicsView::enterEvent(event);
-    if(m_type == DockItemManager::Scale)
-        m_animation->setDirection(QVariantAnimation::Forward);
-}
-
-void AppEffect::leaveEvent(QEvent *event) {
-    QGraphicsView::leaveEvent(event);
-    if(m_type == DockItemManager::Scale) {
-        m_animation->setDirection(QVariantAnimation::Backward);
-        m_animation->start();
-    }
-}
-
 bool AppEffect::eventFilter(QObject *object, QEvent *event) {
-    if(m_type == DockItemManager::Scale && object == m_parent && event->type() == QEvent::Move)
-        move(m_parent->mapToGlobal(QPoint(0, 0)));
+    if(m_type == DockItemManager::Scale && object == m_parent && event->type() == QEvent::Move) {
+        m_frame->setPos(m_parent->mapToGlobal(QPoint(0, 0)));
+        if (m_frame->isVisible())
+            m_overlay->fitToEffects();
+    }
     return false;
-}
\ No newline at end of file
+}
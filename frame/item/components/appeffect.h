@@ -6,41 +6,70 @@
 
 #include <QGraphicsView>
 #include <QGraphicsPixmapItem>
+#include <QGraphicsRectItem>
 #include <QVariantAnimation>
+#include <QElapsedTimer>
 
-class AppEffect : public QGraphicsView {
+/**
+ * @brief The EffectOverlay class 所有图标动画共用的浮层窗口，场景坐标即屏幕坐标。
+ * 窗口只在首次使用时创建，之后随正在播放的动画移动、缩放或隐藏
+ */
+class EffectOverlay : public QGraphicsView {
     Q_OBJECT
     public:
-        static QVariantAnimation* SwingEffect(QWidget *parent, const QPixmap &icon)
+        // below为true时返回置于底层的浮层，供弹出效果使用
+        static EffectOverlay *instance(bool below);
+
+        // 按场景中所有动画的区域调整窗口，没有动画时隐藏
+        void fitToEffects();
+
+    private:
+        explicit EffectOverlay(bool below);
+
+        const bool m_below;
+};
+
+/**
+ * @brief The AppEffect class 图标动画。cacheKey为图标内容的标识，提亮后的图标按它缓存；
+ * grab()等每次都会重新生成的图片传空字符串，不缓存
+ */
+class AppEffect : public QObject {
+    Q_OBJECT
+    public:
+        static QVariantAnimation* SwingEffect(QWidget *parent, const QPixmap &icon, const QString &cacheKey = QString())
         {
-            AppEffect *view = new AppEffect(parent, icon, DockItemManager::Swing);
-            return view->m_animation;
+            AppEffect *effect = new AppEffect(parent, icon, cacheKey, DockItemManager::Swing);
+            return effect->m_animation;
         }
 
-        static QVariantAnimation* JumpEffect(QWidget *parent, const QPixmap &icon, Position position)
+        static QVariantAnimation* JumpEffect(QWidget *parent, const QPixmap &icon, Position position, const QString &cacheKey = QString())
         {
-            AppEffect *view = new AppEffect(parent, icon, DockItemManager::Jump, position);
-            return view->m_animation;
+            AppEffect *effect = new AppEffect(parent, icon, cacheKey, DockItemManager::Jump, position);
+            return effect->m_animation;
         }
 
-        static QVariantAnimation* ScaleEffect(QWidget *parent, const QPixmap &icon, Position position)
+        static QVariantAnimation* ScaleEffect(QWidget *parent, const QPixmap &icon, Position position, const QString &cacheKey = QString())
         {
-            AppEffect *view = new AppEffect(parent, icon, DockItemManager::Scale, position);
-            return view->m_animation;
+            AppEffect *effect = new AppEffect(parent, icon, cacheKey, DockItemManager::Scale, position);
+            return effect->m_animation;
         }
 
-        static QVariantAnimation* PopupEffect(QWidget *parent, const QPixmap &icon, Position position)
+        static QVariantAnimation* PopupEffect(QWidget *parent, const QPixmap &icon, Position position, const QString &cacheKey = QString())
         {
-            AppEffect *view = new AppEffect(parent, icon, DockItemManager::Popup, position);
-            return view->m_animation;
+            AppEffect *effect = new AppEffect(parent, icon, cacheKey, DockItemManager::Popup, position);
+            return effect->m_animation;
         }
+
+        // 由QIcon生成的图标的缓存标识，图标为空时返回空字符串
+        static QString iconKey(const QIcon &icon, const QPixmap &pixmap);
+
+        ~AppEffect() override;
+
     protected:
-        void enterEvent(QEvent *event) override;
-        void leaveEvent(QEvent *event) override;
         bool eventFilter(QObject *object, QEvent *event) override;
 
     private:
-        AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::ActivateAnimationType type, Position position=Bottom);
+        AppEffect(QWidget *parent, const QPixmap &icon, const QString &cacheKey, DockItemManager::ActivateAnimationType type, Position position=Bottom);
 
         void initSwing();
         void initJump();
@@ -52,8 +81,11 @@ private:
     const QPixmap m_icon;
     const Position m_position;
     const DockItemManager::ActivateAnimationType m_type;
-    QGraphicsScene *m_itemScene;
+    EffectOverlay *m_overlay;
+    QGraphicsRectItem *m_frame;     // 动画所占的区域，位置为屏幕坐标，图标超出区域的部分被裁剪
     QGraphicsPixmapItem *m_item;
     QVariantAnimation *m_animation;
+    QElapsedTimer m_runningTimer;   // 以下用于dde.dock.effect日志
+    int m_frameCount;
 };
 #endif /* ifndef SWINGEFFECT */
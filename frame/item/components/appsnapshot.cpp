@@ -21,14 +21,12 @@
 
 #include "appsnapshot.h"
 #include "previewcontainer.h"
+#include "util/windowsnapshotservice.h"
 
 #include <DStyle>
 
 #include <X11/Xlib.h>
 #include <X11/X.h>
-#include <X11/Xutil.h>
-#include <X11/Xatom.h>
-#include <sys/shm.h>
 
 #include <QX11Info>
 #include <QPainter>
@@ -36,20 +34,8 @@
 #include <QSizeF>
 #include <QTimer>
 
-struct SHMInfo {
-    long shmid;
-    long width;
-    long height;
-    long bytesPerLine;
-    long format;
-
-    struct Rect {
-        long x;
-        long y;
-        long width;
-        long height;
-    } rect;
-};
+// 截图四周留出的边距
+static const QMargins SnapshotMargins(8, 8, 8, 8);
 
 AppSnapshot::AppSnapshot(const WId wid, QWidget *parent)
     : QWidget(parent)
@@ -58,6 +44,8 @@ AppSnapshot::AppSnapshot(const WId wid, QWidget *parent)
     , m_waitLeaveTimer(new QTimer(this))
     , m_closeBtn2D(new DIconButton(this))
     , m_wmHelper(DWindowManagerHelper::instance())
+    , m_snapshotWatcher(new QFutureWatcher<WindowThumbnail>(this))
+    , m_snapshotAcquired(false)
 {
     m_closeBtn2D->setFixedSize(24, 24);
     m_closeBtn2D->setObjectName("closebutton-2d");
@@ -84,12 +72,43 @@ AppSnapshot::AppSnapshot(const WId wid, QWidget *parent)
     resize(SNAP_WIDTH, SNAP_HEIGHT);
 
     connect(m_closeBtn2D, &DIconButton::clicked, this, &AppSnapshot::closeWindow, Qt::QueuedConnection);
+    connect(m_snapshotWatcher, &QFutureWatcher<WindowThumbnail>::finished, this, &AppSnapshot::onThumbnailReady);
     connect(m_wmHelper, &DWindowManagerHelper::hasCompositeChanged, this, &AppSnapshot::compositeChanged, Qt::QueuedConnection);
     QTimer::singleShot(1, this, &AppSnapshot::compositeChanged);
 }
 
+AppSnapshot::~AppSnapshot()
+{
+    if (m_snapshotAcquired)
+        WindowSnapshotService::instance()->release(m_wid);
+}
+
+void AppSnapshot::setWId(const WId wid)
+{
+    if (m_wid == wid)
+        return;
+
+    cancelSnapshot();
+
+    WindowSnapshotService *service = WindowSnapshotService::instance();
+    if (m_snapshotAcquired) {
+        service->release(m_wid);
+        service->acquire(wid);
+    }
+
+    m_wid = wid;
+    m_snapshot = QImage();
+    m_snapshotSrcRect = QRectF();
+
+    update();
+}
+
 void AppSnapshot::setCloseAble(const bool value) {
     m_closeAble = value;
+
+    // 控件被复用到不可关闭的窗口上时隐藏关闭按钮
+    if (!m_closeAble)
+        m_closeBtn2D->setVisible(false);
 }
 
 void AppSnapshot::closeWindow() const
@@ -125,6 +144,7 @@ void AppSnapshot::setWindowInfo(const WindowInfo &info)
     QFontMetrics fm(m_title->font());
     QString strTtile = m_title->fontMetrics().elidedText(m_windowInfo.title, Qt::ElideRight, width());
     m_title->setText(strTtile);
+    update();
 }
 
 void AppSnapshot::dragEnterEvent(QDragEnterEvent *e)
@@ -137,69 +157,46 @@ void AppSnapshot::dragEnterEvent(QDragEnterEvent *e)
 
 void AppSnapshot::fetchSnapshot()
 {
-    if (!m_wmHelper->hasComposite())
+    // 尚未分配窗口的控件不需要截图
+    if (!m_wmHelper->hasComposite() || !m_wid)
         return;
 
-    QImage qimage;
-    SHMInfo *info = nullptr;
-    uchar *image_data = nullptr;
-    XImage *ximage = nullptr;
-    unsigned char *prop_to_return_gtk = nullptr;
-
-    do {
-        // get window image from shm(only for deepin app)
-        info = getImageDSHM();
-        if (info) {
-            qDebug() << "get Image from dxcbplugin SHM...";
-            //qDebug() << info->shmid << info->width << info->height << info->bytesPerLine << info->format << info->rect.x << info->rect.y << info->rect.width << info->rect.height;
-            image_data = (uchar *)shmat(info->shmid, 0, 0);
-            if ((qint64)image_data != -1) {
-                m_snapshot = QImage(image_data, info->width, info->height, info->bytesPerLine, (QImage::Format)info->format);
-                m_snapshotSrcRect = QRect(info->rect.x, info->rect.y, info->rect.width, info->rect.height);
-                break;
-            }
-            qDebug() << "invalid pointer of shm!";
-            image_data = nullptr;
-        }
-
-        if (!image_data || qimage.isNull()) {
-            // get window image from XGetImage(a little slow)
-            qDebug() << "get Image from dxcbplugin SHM failed!";
-            qDebug() << "get Image from Xlib...";
-            ximage = getImageXlib();
-            if (!ximage) {
-                qDebug() << "get Image from Xlib failed! giving up...";
-                emit requestCheckWindow();
-                return;
-            }
-            qimage = QImage((const uchar *)(ximage->data), ximage->width, ximage->height, ximage->bytes_per_line, QImage::Format_RGB32);
-        }
+    // 截图与缩放由截图服务完成，窗口未重绘时直接复用任务栏窗口项已有的截图
+    const QSizeF size(rect().marginsRemoved(SnapshotMargins).size());
+    const QFuture<WindowThumbnail> future = WindowSnapshotService::instance()->thumbnail(m_wid, size, devicePixelRatioF());
+    if (future.isCanceled()) {
+        qDebug() << "get window image failed! giving up...";
+        emit requestCheckWindow();
+        return;
+    }
 
-        Q_ASSERT(!qimage.isNull());
+    // 重新截图时旧的结果会被丢弃
+    m_snapshotWatcher->setFuture(future);
+}
 
-        // remove shadow frame
-        m_snapshotSrcRect = rectRemovedShadow(qimage, prop_to_return_gtk);
-        m_snapshot = qimage;
-    } while (false);
+void AppSnapshot::onThumbnailReady()
+{
+    const WindowThumbnail thumbnail = m_snapshotWatcher->result();
+    if (thumbnail.image.isNull())
+        return;
 
-    QSizeF size(rect().marginsRemoved(QMargins(8, 8, 8, 8)).size());
-    const auto ratio = devicePixelRatioF();
-    size = m_snapshotSrcRect.size().scaled(size * ratio, Qt::KeepAspectRatio);
-    qreal scale = qreal(size.width()) / m_snapshotSrcRect.width();
-    m_snapshot = m_snapshot.scaled(qRound(m_snapshot.width() * scale), qRound(m_snapshot.height() * scale),
-                                   Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-    m_snapshotSrcRect.moveTop(m_snapshotSrcRect.top() * scale + 0.5);
-    m_snapshotSrcRect.moveLeft(m_snapshotSrcRect.left() * scale + 0.5);
-    m_snapshotSrcRect.setWidth(size.width() - 0.5);
-    m_snapshotSrcRect.setHeight(size.height() - 0.5);
-    m_snapshot.setDevicePixelRatio(ratio);
-
-    if (image_data) shmdt(image_data);
-    if (ximage) XDestroyImage(ximage);
-    if (info) XFree(info);
-    if (prop_to_return_gtk) XFree(prop_to_return_gtk);
+    m_snapshot = thumbnail.image;
+    m_snapshotSrcRect = thumbnail.rect;
 
     update();
+
+    emit snapshotReady(m_wid);
+}
+
+QSizeF AppSnapshot::defaultThumbnailSize()
+{
+    return QRect(0, 0, SNAP_WIDTH, SNAP_HEIGHT).marginsRemoved(SnapshotMargins).size();
+}
+
+void AppSnapshot::cancelSnapshot()
+{
+    // 截图服务返回的QFuture可能与其他控件共用，只断开监听而不取消
+    m_snapshotWatcher->setFuture(QFuture<WindowThumbnail>());
 }
 
 void AppSnapshot::enterEvent(QEvent *e)
@@ -264,6 +261,29 @@ void AppSnapshot::paintEvent(QPaintEvent *e)
     painter.drawRoundedRect(m_snapshotSrcRect, radius * ratio, radius * ratio);
 }
 
+void AppSnapshot::showEvent(QShowEvent *e)
+{
+    QWidget::showEvent(e);
+
+    if (!m_snapshotAcquired) {
+        m_snapshotAcquired = true;
+        WindowSnapshotService::instance()->acquire(m_wid);
+    }
+}
+
+void AppSnapshot::hideEvent(QHideEvent *e)
+{
+    QWidget::hideEvent(e);
+
+    // 预览已关闭，不再需要尚未完成的缩略图
+    cancelSnapshot();
+
+    if (m_snapshotAcquired) {
+        m_snapshotAcquired = false;
+        WindowSnapshotService::instance()->release(m_wid);
+    }
+}
+
 void AppSnapshot::resizeEvent(QResizeEvent *e)
 {
     QWidget::resizeEvent(e);
@@ -292,65 +312,3 @@ bool AppSnapshot::eventFilter(QObject *watched, QEvent *e)
 
     return QWidget::eventFilter(watched, e);
 }
-
-SHMInfo *AppSnapshot::getImageDSHM()
-{
-    const auto display = QX11Info::display();
-
-    Atom atom_prop = XInternAtom(display, "_DEEPIN_DXCB_SHM_INFO", true);
-    if (!atom_prop) {
-        return nullptr;
-    }
-
-    Atom actual_type_return_deepin_shm;
-    int actual_format_return_deepin_shm;
-    unsigned long nitems_return_deepin_shm;
-    unsigned long bytes_after_return_deepin_shm;
-    unsigned char *prop_return_deepin_shm;
-
-    XGetWindowProperty(display, m_wid, atom_prop, 0, 32 * 9, false, AnyPropertyType,
-                       &actual_type_return_deepin_shm, &actual_format_return_deepin_shm, &nitems_return_deepin_shm,
-                       &bytes_after_return_deepin_shm, &prop_return_deepin_shm);
-
-    //qDebug() << actual_type_return_deepin_shm << actual_format_return_deepin_shm << nitems_return_deepin_shm << bytes_after_return_deepin_shm << prop_return_deepin_shm;
-
-    return reinterpret_cast<SHMInfo *>(prop_return_deepin_shm);
-}
-
-XImage *AppSnapshot::getImageXlib()
-{
-    const auto display = QX11Info::display();
-    Window unused_window;
-    int unused_int;
-    unsigned unused_uint, w, h;
-    XGetGeometry(display, m_wid, &unused_window, &unused_int, &unused_int, &w, &h, &unused_uint, &unused_uint);
-    return XGetImage(display, m_wid, 0, 0, w, h, AllPlanes, ZPixmap);
-}
-
-QRect AppSnapshot::rectRemovedShadow(const QImage &qimage, unsigned char *prop_to_return_gtk)
-{
-    const auto display = QX11Info::display();
-
-    const Atom gtk_frame_extents = XInternAtom(display, "_GTK_FRAME_EXTENTS", true);
-    Atom actual_type_return_gtk;
-    int actual_format_return_gtk;
-    unsigned long n_items_return_gtk;
-    unsigned long bytes_after_return_gtk;
-
-    const auto r = XGetWindowProperty(display, m_wid, gtk_frame_extents, 0, 4, false, XA_CARDINAL,
-                                      &actual_type_return_gtk, &actual_format_return_gtk, &n_items_return_gtk, &bytes_after_return_gtk, &prop_to_return_gtk);
-    if (!r && prop_to_return_gtk && n_items_return_gtk == 4 && actual_format_return_gtk == 32) {
-        qDebug() << "remove shadow frame...";
-        const unsigned long *extents = reinterpret_cast<const unsigned long *>(prop_to_return_gtk);
-        const int left = extents[0];
-        const int right = extents[1];
-        const int top = extents[2];
-        const int bottom = extents[3];
-        const int width = qimage.width();
-        const int height = qimage.height();
-
-        return QRect(left, top, width - left - right, height - top - bottom);
-    } else {
-        return QRect(0, 0, qimage.width(), qimage.height());
-    }
-}
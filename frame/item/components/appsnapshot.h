@@ -25,8 +25,10 @@
 #include <QWidget>
 #include <QDebug>
 #include <QTimer>
+#include <QFutureWatcher>
 #include "../tipswidget.h"
 #include "../../taskmanager/windowinfomap.h"
+#include "../../util/windowcapture.h"
 
 #include <DIconButton>
 #include <DWindowManagerHelper>
@@ -37,18 +39,17 @@ DGUI_USE_NAMESPACE
 #define SNAP_WIDTH       200
 #define SNAP_HEIGHT      130
 
-struct SHMInfo;
-struct _XImage;
-typedef _XImage XImage;
-
 class AppSnapshot : public QWidget
 {
     Q_OBJECT
 
 public:
     explicit AppSnapshot(const WId wid, QWidget *parent = 0);
+    ~AppSnapshot() override;
 
     inline WId wid() const { return m_wid; }
+    // 预览列表滚动时复用控件显示另一个窗口，原窗口的截图随即丢弃
+    void setWId(const WId wid);
     inline bool attentioned() { return m_windowInfo.attention; }
     inline bool closeAble() const { return m_closeAble; }
     void setCloseAble(const bool value);
@@ -56,16 +57,21 @@ public:
     inline const QRectF snapshotGeometry() const { return m_snapshotSrcRect; }
     inline const QString title() { return m_windowInfo.title; }
 
+    // 默认大小下截图的显示区域，用于提前生成相同大小的缩略图
+    static QSizeF defaultThumbnailSize();
+
 signals:
     void entered(const WId wid) const;
     void clicked(const WId wid) const;
     void requestCheckWindow() const;
+    void snapshotReady(const WId wid) const;
 
 public slots:
     void fetchSnapshot();
     void closeWindow() const;
     void compositeChanged() const;
     void setWindowInfo(const WindowInfo &info);
+    void cancelSnapshot();
 
 private:
     void dragEnterEvent(QDragEnterEvent *e) override;
@@ -73,14 +79,14 @@ private:
     void leaveEvent(QEvent *e) override;
     void paintEvent(QPaintEvent *e) override;
     void resizeEvent(QResizeEvent *e) override;
+    void showEvent(QShowEvent *e) override;
+    void hideEvent(QHideEvent *e) override;
     void mousePressEvent(QMouseEvent *e) override;
     bool eventFilter(QObject *watched, QEvent *e) override;
-    SHMInfo *getImageDSHM();
-    XImage * getImageXlib();
-    QRect rectRemovedShadow(const QImage &qimage, unsigned char *prop_to_return_gtk);
+    void onThumbnailReady();
 
 private:
-    const WId m_wid;
+    WId m_wid;
     WindowInfo m_windowInfo;
 
     bool m_closeAble;
@@ -92,6 +98,8 @@ private:
     QTimer *m_waitLeaveTimer;
     DIconButton *m_closeBtn2D;
     DWindowManagerHelper *m_wmHelper;
+    QFutureWatcher<WindowThumbnail> *m_snapshotWatcher;
+    bool m_snapshotAcquired;
 };
 
 #endif // APPSNAPSHOT_H
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dircomposite.h"
+
+#include <QPainter>
+#include <QPen>
+
+QString DirComposite::key(const QSize &size, qreal ratio, const QList<Member> &members)
+{
+    QString key = QString("%1x%2@%3").arg(size.width()).arg(size.height()).arg(ratio);
+    for (const Member &member : members.mid(0, MaxMembers))
+        key += QString(":%1/%2").arg(member.icon.cacheKey()).arg(member.width);
+
+    return key;
+}
+
+QPixmap DirComposite::pixmap(const QSize &size, qreal ratio, const QList<Member> &members)
+{
+    const QString key = DirComposite::key(size, ratio, members);
+    if (key == m_key && !m_pixmap.isNull())
+        return m_pixmap;
+
+    m_pixmap = render(size, ratio, members.mid(0, MaxMembers));
+    m_key = key;
+    return m_pixmap;
+}
+
+QPixmap DirComposite::render(const QSize &size, qreal ratio, const QList<Member> &members)
+{
+    QPixmap composite(size * ratio);
+    composite.setDevicePixelRatio(ratio);
+    composite.fill(Qt::transparent);
+
+    QPainter painter(&composite);
+    painter.setPen(QPen(Qt::darkCyan, 2));
+
+    const QRect rect(QPoint(0, 0), size);
+    QRect border = rect.adjusted(2, 2, -2, -2);
+    QRect line(3, 3, border.width()-2, border.height()-2);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.drawRoundedRect(line, 6, 6, Qt::AbsoluteSize);
+
+    int padding = 8;
+    int spacing = 4;
+    qreal w = (rect.width() - spacing) / 2 - padding;
+    int i = 0;
+    for (const Member &member : members)
+    {
+        const QPixmap pixmap = member.icon.isNull() ? QPixmap(":/icons/resources/application-x-desktop.svg")
+                                                    : member.icon.pixmap(member.width * .9);
+
+        QRect appRect;
+
+        if(i == 0)
+            appRect = QRect(padding, padding, w, w);
+        else if (i == 1)
+            appRect = QRect(padding + w + spacing, padding, w, w);
+        else if (i == 2)
+            appRect = QRect(padding, padding + w + spacing, w, w);
+        else if (i == 3)
+            appRect = QRect(padding + w + spacing, padding + w + spacing, w, w);
+
+        painter.drawPixmap(appRect, pixmap);
+        ++i;
+    }
+
+    return composite;
+}
@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DIRCOMPOSITE_H
+#define DIRCOMPOSITE_H
+
+#include <QIcon>
+#include <QList>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+/**
+ * @brief The DirComposite class 集合的合成图：边框与前四个成员的图标。
+ * 内容由大小、缩放比与成员图标共同决定，都没有变化时沿用上次生成的结果，悬停等动画只需重绘背景
+ */
+class DirComposite
+{
+public:
+    struct Member {
+        QIcon icon;     // 为空时使用默认的应用图标
+        int width;      // 成员自身的宽度，图标按其0.9倍渲染
+    };
+
+    static const int MaxMembers = 4;
+
+    /**
+     * @brief key 合成图内容的标识，成员只取前四个
+     * @param size 集合的大小（逻辑像素）
+     * @param ratio 设备缩放比
+     * @param members
+     * @return
+     */
+    static QString key(const QSize &size, qreal ratio, const QList<Member> &members);
+
+    /**
+     * @brief pixmap 返回合成图，标识与上次相同时不重新生成
+     * @param size 集合的大小（逻辑像素）
+     * @param ratio 设备缩放比
+     * @param members
+     * @return
+     */
+    QPixmap pixmap(const QSize &size, qreal ratio, const QList<Member> &members);
+
+private:
+    static QPixmap render(const QSize &size, qreal ratio, const QList<Member> &members);
+
+private:
+    QPixmap m_pixmap;
+    QString m_key;
+};
+
+#endif // DIRCOMPOSITE_H
@@ -0,0 +1,266 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "foldermodel.h"
+
+#include <QDir>
+#include <QFileIconProvider>
+#include <QFileSystemWatcher>
+#include <QIcon>
+#include <QImageReader>
+#include <QMimeData>
+#include <QMimeDatabase>
+#include <QTimer>
+#include <QUrl>
+#include <QtConcurrent>
+
+static QFileIconProvider provider;
+
+static const int IconPixmapSize = 70;
+// 一次在后台加载的图标个数
+static const int IconBatchSize = 32;
+
+struct FolderIcon {
+    QString path;
+    QDateTime modified;
+    QString iconName;
+    QString genericIconName;
+    QImage thumbnail;       // 图片文件的缩略图
+};
+
+namespace {
+
+// 与目录内容的比较顺序一致：忽略大小写按名称排序
+bool entryLessThan(const FolderEntry &a, const FolderEntry &b)
+{
+    const int result = QString::compare(a.name, b.name, Qt::CaseInsensitive);
+    return result != 0 ? result < 0 : a.name < b.name;
+}
+
+QVector<FolderEntry> scanFolder(const QString &path)
+{
+    QVector<FolderEntry> entries;
+    const QFileInfoList files = QDir(path).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDir::NoSort);
+    entries.reserve(files.size());
+    for (const QFileInfo &file : files)
+        entries.append(FolderEntry{file.fileName(), file.absoluteFilePath(), file.isDir(), file.lastModified()});
+
+    std::sort(entries.begin(), entries.end(), entryLessThan);
+    return entries;
+}
+
+// 在工作线程中执行：识别文件类型需要读取文件内容，图片还需要解码，都不能放在界面线程
+FolderIcon loadIcon(const QString &path, const QDateTime &modified)
+{
+    FolderIcon icon{path, modified, QString(), QString(), QImage()};
+
+    const QMimeType mime = QMimeDatabase().mimeTypeForFile(path);
+    icon.iconName = mime.iconName();
+    icon.genericIconName = mime.genericIconName();
+
+    if (mime.name().startsWith("image/")) {
+        QImageReader reader(path);
+        const QSize size = reader.size();
+        if (size.isValid())
+            reader.setScaledSize(size.scaled(IconPixmapSize, IconPixmapSize, Qt::KeepAspectRatio));
+        icon.thumbnail = reader.read();
+    }
+
+    return icon;
+}
+
+}
+
+FolderModel::FolderModel(const QString &path, QObject *parent) : QAbstractListModel(parent)
+, m_path(path)
+, m_watcher(new QFileSystemWatcher({path}, this))
+, m_refreshTimer(new QTimer(this))
+, m_scanWatcher(new QFutureWatcher<QVector<FolderEntry>>(this))
+{
+    // 短时间内连续的变化只扫描一次
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(100);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_refreshTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
+    connect(m_refreshTimer, &QTimer::timeout, this, &FolderModel::refresh);
+    connect(m_scanWatcher, &QFutureWatcher<QVector<FolderEntry>>::finished, this, [this] {
+        applyEntries(m_scanWatcher->result());
+    });
+
+    refresh();
+}
+
+int FolderModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+QVariant FolderModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size())
+        return QVariant();
+
+    const FolderEntry &entry = m_entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return entry.name;
+    case FilePathRole:
+        return entry.path;
+    case Qt::DecorationRole: {
+        auto it = m_icons.constFind(entry.path);
+        if (it != m_icons.constEnd())
+            return it.value();
+
+        const_cast<FolderModel *>(this)->requestIcon(entry);
+        return provider.icon(entry.dir ? QFileIconProvider::Folder : QFileIconProvider::File).pixmap(IconPixmapSize, IconPixmapSize);
+    }
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags FolderModel::flags(const QModelIndex &index) const
+{
+    return QAbstractListModel::flags(index) | Qt::ItemIsDragEnabled;
+}
+
+QStringList FolderModel::mimeTypes() const
+{
+    return QStringList("text/uri-list");
+}
+
+QMimeData *FolderModel::mimeData(const QModelIndexList &indexes) const
+{
+    QMimeData *data = new QMimeData();
+    QList<QUrl> urls;
+    for(auto index : indexes)
+        urls << QUrl::fromLocalFile(index.data(FilePathRole).toString());
+
+    data->setUrls(urls);
+    return data;
+}
+
+void FolderModel::refresh()
+{
+    // 新的扫描开始后，尚未完成的旧结果会被丢弃
+    const QString path = m_path;
+    m_scanWatcher->setFuture(QtConcurrent::run([path] { return scanFolder(path); }));
+}
+
+/**
+ * @brief FolderModel::applyEntries 两个列表都已排序，逐个比较得出新增、删除和修改过的文件，连续的新增或删除合并为一次通知
+ */
+void FolderModel::applyEntries(const QVector<FolderEntry> &entries)
+{
+    int row = 0;
+    int next = 0;
+
+    while (row < m_entries.size() || next < entries.size()) {
+        if (next == entries.size() || (row < m_entries.size() && entryLessThan(m_entries.at(row), entries.at(next)))) {
+            int last = row;
+            while (last + 1 < m_entries.size() && (next == entries.size() || entryLessThan(m_entries.at(last + 1), entries.at(next))))
+                ++last;
+
+            beginRemoveRows(QModelIndex(), row, last);
+            for (int i = row; i <= last; ++i)
+                m_icons.remove(m_entries.at(i).path);
+            m_entries.remove(row, last - row + 1);
+            endRemoveRows();
+        } else if (row == m_entries.size() || entryLessThan(entries.at(next), m_entries.at(row))) {
+            int last = next;
+            while (last + 1 < entries.size() && (row == m_entries.size() || entryLessThan(entries.at(last + 1), m_entries.at(row))))
+                ++last;
+
+            const int count = last - next + 1;
+            beginInsertRows(QModelIndex(), row, row + count - 1);
+            for (int i = 0; i < count; ++i)
+                m_entries.insert(row + i, entries.at(next + i));
+            endInsertRows();
+
+            row += count;
+            next += count;
+        } else {
+            const FolderEntry &entry = entries.at(next);
+            if (m_entries.at(row).modified != entry.modified || m_entries.at(row).dir != entry.dir) {
+                m_entries[row] = entry;
+                m_icons.remove(entry.path);
+                emit dataChanged(index(row), index(row));
+            }
+            ++row;
+            ++next;
+        }
+    }
+}
+
+void FolderModel::requestIcon(const FolderEntry &entry)
+{
+    if (m_loadingIcons.contains(entry.path))
+        return;
+
+    m_loadingIcons.insert(entry.path);
+    m_pendingIcons.append(qMakePair(entry.path, entry.modified));
+
+    // 同一次绘制中请求的图标一起加载
+    if (m_pendingIcons.size() == 1)
+        QTimer::singleShot(0, this, &FolderModel::loadPendingIcons);
+}
+
+void FolderModel::loadPendingIcons()
+{
+    while (!m_pendingIcons.isEmpty()) {
+        const QList<QPair<QString, QDateTime>> batch = m_pendingIcons.mid(0, IconBatchSize);
+        m_pendingIcons = m_pendingIcons.mid(batch.size());
+
+        QFutureWatcher<QList<FolderIcon>> *watcher = new QFutureWatcher<QList<FolderIcon>>(this);
+        connect(watcher, &QFutureWatcher<QList<FolderIcon>>::finished, this, [this, watcher] {
+            for (const FolderIcon &icon : watcher->result())
+                applyIcon(icon);
+            watcher->deleteLater();
+        });
+        watcher->setFuture(QtConcurrent::run([batch] {
+            QList<FolderIcon> icons;
+            for (const auto &file : batch)
+                icons.append(loadIcon(file.first, file.second));
+            return icons;
+        }));
+    }
+}
+
+void FolderModel::applyIcon(const FolderIcon &icon)
+{
+    m_loadingIcons.remove(icon.path);
+
+    int row = -1;
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (m_entries.at(i).path == icon.path) {
+            row = i;
+            break;
+        }
+    }
+
+    // 加载期间文件已被删除，丢弃结果
+    if (row == -1)
+        return;
+
+    // 加载期间文件被修改，结果作废。修改时视图重新请求的图标因为仍在加载而被忽略，
+    // 这里再通知一次，让视图按新的修改时间重新请求
+    if (m_entries.at(row).modified != icon.modified) {
+        emit dataChanged(index(row), index(row), {Qt::DecorationRole});
+        return;
+    }
+
+    // 主题图标只能在界面线程中创建，Qt会按名称缓存
+    QPixmap pixmap;
+    if (!icon.thumbnail.isNull())
+        pixmap = QPixmap::fromImage(icon.thumbnail);
+    else if (m_entries.at(row).dir)
+        pixmap = provider.icon(QFileIconProvider::Folder).pixmap(IconPixmapSize, IconPixmapSize);
+    else
+        pixmap = QIcon::fromTheme(icon.iconName, QIcon::fromTheme(icon.genericIconName, provider.icon(QFileIconProvider::File)))
+                     .pixmap(IconPixmapSize, IconPixmapSize);
+
+    m_icons.insert(icon.path, pixmap);
+    emit dataChanged(index(row), index(row), {Qt::DecorationRole});
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FOLDERMODEL_H
+#define FOLDERMODEL_H
+
+#include <QAbstractListModel>
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QPixmap>
+#include <QSet>
+#include <QVector>
+
+class QFileSystemWatcher;
+class QTimer;
+
+struct FolderEntry {
+    QString name;
+    QString path;
+    bool dir;
+    QDateTime modified;
+};
+
+struct FolderIcon;
+
+/**
+ * @brief The FolderModel class 文件夹中的文件列表。目录变化时在后台重新扫描，与现有列表比较后只增删变化的行；
+ * 图标只在视图需要时加载，加载完成前显示通用的文件图标
+ */
+class FolderModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    enum Roles {
+        FilePathRole = Qt::UserRole + 1,
+    };
+
+    explicit FolderModel(const QString &path, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QStringList mimeTypes() const override;
+    QMimeData *mimeData(const QModelIndexList &indexes) const override;
+
+    void refresh();
+
+private:
+    void applyEntries(const QVector<FolderEntry> &entries);
+    void requestIcon(const FolderEntry &entry);
+    void loadPendingIcons();
+    void applyIcon(const FolderIcon &icon);
+
+private:
+    QString m_path;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_refreshTimer;
+    QFutureWatcher<QVector<FolderEntry>> *m_scanWatcher;
+    QVector<FolderEntry> m_entries;
+    QHash<QString, QPixmap> m_icons;
+    QSet<QString> m_loadingIcons;
+    QList<QPair<QString, QDateTime>> m_pendingIcons;
+};
+
+#endif // FOLDERMODEL_H
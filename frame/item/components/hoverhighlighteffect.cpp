@@ -44,6 +44,7 @@ bool HoverHighlightEffect::eventFilter(QObject *object, QEvent *event) {
             update();
         } else if(event->type() == QEvent::Leave) {
             m_highlighting = false;
+            m_highlightPixmap = QPixmap();
             update();
         }
     }
@@ -55,8 +56,18 @@ void HoverHighlightEffect::draw(QPainter *painter)
 {
     const QPixmap pix = sourcePixmap(Qt::DeviceCoordinates);
 
-    if (m_highlighting)
-        painter->drawPixmap(0, 0, Utils::lighterEffect(pix));
-    else
+    if (!m_highlighting) {
         painter->drawPixmap(0, 0, pix);
+        return;
+    }
+
+    // 控件作为源时sourcePixmap每次都重新渲染，不能用它的cacheKey判断内容是否变化，
+    // 改由控件给出绘制内容的标识，内容不变时高亮结果只计算一次
+    const QString key = m_keyFunction ? m_keyFunction() : QString();
+    if (key.isEmpty() || key != m_highlightKey || m_highlightPixmap.isNull()) {
+        m_highlightPixmap = Utils::lighterEffect(pix);
+        m_highlightKey = key;
+    }
+
+    painter->drawPixmap(0, 0, m_highlightPixmap);
 }
@@ -23,6 +23,9 @@
 #define HOVERHIGHLIGHTEFFECT_H
 
 #include <QGraphicsEffect>
+#include <QPixmap>
+
+#include <functional>
 
 class HoverHighlightEffect : public QGraphicsEffect
 {
@@ -33,6 +36,8 @@ public:
     ~HoverHighlightEffect();
 
     void setHighlighting(const bool highlighting) { m_highlighting = highlighting; }
+    // 返回源控件当前绘制内容的标识，标识不变时复用上次的高亮图；未设置或返回空时每次都重新计算
+    void setKeyFunction(const std::function<QString()> &keyFunction) { m_keyFunction = keyFunction; }
 
 protected:
     void draw(QPainter *painter) override;
@@ -40,6 +45,9 @@ protected:
 
 private:
     bool m_highlighting;
+    QPixmap m_highlightPixmap;      // 最近一次计算的高亮图
+    QString m_highlightKey;         // 高亮图对应的内容标识
+    std::function<QString()> m_keyFunction;
 };
 
 #endif // HOVERHIGHLIGHTEFFECT_H
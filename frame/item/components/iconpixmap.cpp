@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "iconpixmap.h"
+
+const QPixmap &IconPixmap::pixmap(const QIcon &icon, int size, qreal ratio)
+{
+    if (!m_pixmap.isNull() && m_iconKey == icon.cacheKey() && m_size == size && qFuzzyCompare(m_ratio, ratio))
+        return m_pixmap;
+
+    m_iconKey = icon.cacheKey();
+    m_size = size;
+    m_ratio = ratio;
+    if (icon.isNull()) {
+        m_pixmap = QPixmap(":/icons/resources/application-x-desktop.svg");
+        m_sourceRect = QRectF();
+    } else {
+        const QPixmap pixmap = icon.pixmap(size);
+        m_pixmap = pixmap.scaled(size, size);
+        m_sourceRect = pixmap.rect();
+    }
+
+    return m_pixmap;
+}
+
+void IconPixmap::clear()
+{
+    m_pixmap = QPixmap();
+    m_sourceRect = QRectF();
+}
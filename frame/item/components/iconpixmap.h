@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ICONPIXMAP_H
+#define ICONPIXMAP_H
+
+#include <QIcon>
+#include <QPixmap>
+#include <QRectF>
+
+/**
+ * @brief The IconPixmap class 按尺寸与缩放比预先渲染的图标。图标、尺寸或缩放比变化后第一次绘制时才重新渲染，
+ * 悬停动画等频繁重绘时只需直接绘制
+ */
+class IconPixmap
+{
+public:
+    /**
+     * @brief pixmap 返回渲染好的图标
+     * @param icon 为空时使用默认的应用图标
+     * @param size 图标大小（逻辑像素）
+     * @param ratio 设备缩放比
+     * @return
+     */
+    const QPixmap &pixmap(const QIcon &icon, int size, qreal ratio);
+
+    // 最近一次渲染时QIcon给出的原始区域，用于把图标放在控件中央
+    QRectF sourceRect() const { return m_sourceRect; }
+
+    void clear();
+
+private:
+    QPixmap m_pixmap;
+    QRectF m_sourceRect;
+    qint64 m_iconKey = 0;
+    int m_size = 0;
+    qreal m_ratio = 0;
+};
+
+#endif // ICONPIXMAP_H
@@ -25,31 +25,45 @@
 #include <QScreen>
 #include <QApplication>
 #include <QDragEnterEvent>
+#include <QLoggingCategory>
+#include <QWheelEvent>
 
 #define SPACING           0
 #define MARGIN            0
 #define SNAP_HEIGHT_WITHOUT_COMPOSITE       30
 
+// QT_LOGGING_RULES="dde.dock.preview.debug=true"时输出弹出预览的耗时
+Q_LOGGING_CATEGORY(previewLog, "dde.dock.preview", QtInfoMsg)
+
 PreviewContainer *PreviewContainer::instance() {
     static PreviewContainer *preview = new PreviewContainer;
     return preview;
 }
 
-PreviewContainer *PreviewContainer::instance(const WindowInfoMap &infos, const QVector<uint> allowClose, const Dock::Position dockPos)
+PreviewContainer *PreviewContainer::instance(const WindowInfoMap &infos, const QVector<uint> allowClose, const Dock::Position dockPos, QScreen *screen)
 {
     static PreviewContainer *preview = instance();
     preview->disconnect();
+    preview->m_firstThumbnailTimer.start();
+    preview->m_firstIndex = 0;
+    preview->m_screen = screen;
     preview->setWindowInfos(infos, allowClose);
     preview->updateSnapshots();
     preview->updateLayoutDirection(dockPos);
+
+    qCDebug(previewLog) << "popup prepared in" << preview->m_firstThumbnailTimer.elapsed() << "ms," << infos.size()
+                        << "windows," << preview->m_snapshots.size() << "snapshot widgets";
     return preview;
 }
 
 PreviewContainer::PreviewContainer() : QWidget(),
     m_needActivate(false),
+    m_firstIndex(0),
+    m_wheelDelta(0),
     m_floatingPreview(new FloatingPreview(this)),
     m_mouseLeaveTimer(new QTimer(this)),
-    m_wmHelper(DWindowManagerHelper::instance())
+    m_wmHelper(DWindowManagerHelper::instance()),
+    m_currentWId(0)
 {
     m_windowListLayout = new QBoxLayout(QBoxLayout::LeftToRight);
     m_windowListLayout->setSpacing(SPACING);
@@ -74,29 +88,14 @@ PreviewContainer::PreviewContainer() : QWidget(),
 
 void PreviewContainer::setWindowInfos(const WindowInfoMap &infos, const QVector<uint> allowClose)
 {
-    // check removed window
-    for (auto it(m_snapshots.begin()); it != m_snapshots.end();)
-    {
-        if (!infos.contains(it.key()))
-        {
-            m_windowListLayout->removeWidget(it.value());
-            it.value()->deleteLater();
-            it = m_snapshots.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    m_windowInfos = infos;
+    m_allowClose = allowClose;
 
+    m_windowList.clear();
     for (auto it(infos.cbegin()); it != infos.cend(); ++it)
-    {
-        const WId key = it.key();
-        if (!m_snapshots.contains(key))
-            appendSnapWidget(key);
-        m_snapshots[key]->setWindowInfo(it.value());
-        m_snapshots[key]->setCloseAble(allowClose.contains(key));//qInfo()<<"previewclose wId: " << key << ", closeable: " << allowClose;
-    }
+        m_windowList.append(it.key());
 
-    if (m_snapshots.isEmpty())
+    if (m_windowList.isEmpty())
     {
         emit requestCancelPreviewWindow();
         emit requestHidePopup();
@@ -106,10 +105,40 @@ void PreviewContainer::setWindowInfos(const WindowInfoMap &infos, const QVector<
 
 void PreviewContainer::updateSnapshots()
 {
+    m_staleSnapshots.clear();
     for (AppSnapshot *snap : m_snapshots)
         snap->fetchSnapshot();
 }
 
+void PreviewContainer::updateWindowInfo(const WId wid, const WindowInfo &info)
+{
+    if (!m_windowInfos.contains(wid))
+        return;
+
+    m_windowInfos[wid] = info;
+
+    for (AppSnapshot *snap : m_snapshots) {
+        if (snap->wid() == wid)
+            snap->setWindowInfo(info);
+    }
+}
+
+void PreviewContainer::removeWindowInfo(const WId wid)
+{
+    if (!m_windowList.removeOne(wid))
+        return;
+
+    m_windowInfos.remove(wid);
+
+    if (m_windowList.isEmpty())
+    {
+        emit requestCancelPreviewWindow();
+        emit requestHidePopup();
+    }
+    adjustSize();
+    fetchStaleSnapshots();
+}
+
 void PreviewContainer::updateLayoutDirection(const Dock::Position dockPos)
 {
     if (m_wmHelper->hasComposite() && (dockPos == Dock::Top || dockPos == Dock::Bottom))
@@ -118,6 +147,7 @@ void PreviewContainer::updateLayoutDirection(const Dock::Position dockPos)
         m_windowListLayout->setDirection(QBoxLayout::TopToBottom);
 
     adjustSize();
+    fetchStaleSnapshots();
 }
 
 void PreviewContainer::checkMouseLeave()
@@ -146,10 +176,37 @@ void PreviewContainer::prepareHide()
     m_mouseLeaveTimer->start();
 }
 
+int PreviewContainer::visibleSnapshotCount(const int count, const Qt::Orientation orientation, const QScreen *screen)
+{
+    const QRect r = (screen ? screen : qApp->primaryScreen())->geometry();
+    const int padding = 20;
+
+    int length = SNAP_HEIGHT_WITHOUT_COMPOSITE;
+    if (DWindowManagerHelper::instance()->hasComposite())
+        length = orientation == Qt::Horizontal ? SNAP_WIDTH : SNAP_HEIGHT;
+
+    const int available = (orientation == Qt::Horizontal ? r.width() : r.height()) - padding - MARGIN * 2;
+    return std::min(count, std::max(1, (available + SPACING) / (length + SPACING)));
+}
+
 void PreviewContainer::adjustSize()
 {
-    const int count = m_snapshots.size();
     const bool composite = m_wmHelper->hasComposite();
+    const bool horizontal = m_windowListLayout->direction() == QBoxLayout::LeftToRight;
+    const int count = visibleSnapshotCount(m_windowList.size(), horizontal ? Qt::Horizontal : Qt::Vertical, m_screen);
+
+    // 只创建能完整显示的控件，窗口数量再多弹窗也不会超出屏幕
+    while (m_snapshots.size() < count)
+        appendSnapWidget();
+    while (m_snapshots.size() > count) {
+        AppSnapshot *snap = m_snapshots.takeLast();
+        m_staleSnapshots.removeOne(snap);
+        m_windowListLayout->removeWidget(snap);
+        snap->deleteLater();
+    }
+
+    scrollTo(m_firstIndex);
+
     if (!composite)
     {
         const int h = SNAP_HEIGHT_WITHOUT_COMPOSITE * count + MARGIN * 2 + SPACING * (count - 1);
@@ -157,41 +214,108 @@ void PreviewContainer::adjustSize()
         return;
     }
 
-    const QRect r = qApp->primaryScreen()->geometry();
-    const int padding = 20;
-
-    const bool horizontal = m_windowListLayout->direction() == QBoxLayout::LeftToRight;
     if (horizontal)
     {
         const int h = SNAP_HEIGHT + MARGIN * 2;
         const int w = SNAP_WIDTH * count + MARGIN * 2 + SPACING * (count - 1);
 
-        setFixedHeight(h);
-        setFixedWidth(std::min(w, r.width() - padding));
+        setFixedSize(w, h);
     } else {
         const int w = SNAP_WIDTH + MARGIN * 2;
         const int h = SNAP_HEIGHT * count + MARGIN * 2 + SPACING * (count - 1);
 
-        setFixedWidth(w);
-        setFixedHeight(std::min(h, r.height() - padding));
+        setFixedSize(w, h);
     }
 }
 
-void PreviewContainer::appendSnapWidget(const WId wid)
+void PreviewContainer::appendSnapWidget()
 {
-    AppSnapshot *snap = new AppSnapshot(wid);
+    AppSnapshot *snap = new AppSnapshot(0);
 
     connect(snap, &AppSnapshot::clicked, this, &PreviewContainer::onSnapshotClicked, Qt::QueuedConnection);
     connect(snap, &AppSnapshot::entered, this, &PreviewContainer::previewEntered, Qt::QueuedConnection);
     connect(snap, &AppSnapshot::requestCheckWindow, this, &PreviewContainer::requestCheckWindows, Qt::QueuedConnection);
+    connect(snap, &AppSnapshot::snapshotReady, this, &PreviewContainer::onSnapshotReady);
 
     m_windowListLayout->addWidget(snap);
 
-    m_snapshots.insert(wid, snap);
+    m_snapshots.append(snap);
+}
 
-    // refresh if visible
-    if (isVisible())
-        snap->fetchSnapshot();
+/**
+ * @brief PreviewContainer::updateSnapWidgets 按当前的滚动位置给每个控件分配窗口，只记录换了窗口的控件，
+ * 由调用者决定何时截图，避免与updateSnapshots重复截图
+ */
+void PreviewContainer::updateSnapWidgets()
+{
+    for (int i = 0; i < m_snapshots.size(); ++i) {
+        AppSnapshot *snap = m_snapshots.at(i);
+        const WId wid = m_windowList.value(m_firstIndex + i);
+        if (snap->wid() != wid && !m_staleSnapshots.contains(snap))
+            m_staleSnapshots.append(snap);
+
+        snap->setWId(wid);
+        snap->setWindowInfo(m_windowInfos.value(wid));
+        snap->setCloseAble(m_allowClose.contains(wid));
+    }
+}
+
+/**
+ * @brief PreviewContainer::fetchStaleSnapshots 预览可见时只给换了窗口的控件重新截图
+ */
+void PreviewContainer::fetchStaleSnapshots()
+{
+    if (isVisible()) {
+        for (AppSnapshot *snap : m_staleSnapshots)
+            snap->fetchSnapshot();
+    }
+
+    m_staleSnapshots.clear();
+}
+
+void PreviewContainer::scrollTo(int index)
+{
+    index = std::max(0, std::min(index, m_windowList.size() - m_snapshots.size()));
+    m_firstIndex = index;
+
+    updateSnapWidgets();
+
+    // 控件没有移动，鼠标下的控件换成了另一个窗口，跟着预览新的窗口
+    AppSnapshot *tracked = m_floatingPreview->trackedWindow();
+    if (tracked && m_floatingPreview->isVisible() && tracked->wid() != m_currentWId) {
+        m_currentWId = tracked->wid();
+        m_floatingPreview->trackWindow(tracked);
+        emit requestPreviewWindow(m_currentWId);
+    }
+}
+
+void PreviewContainer::wheelEvent(QWheelEvent *e)
+{
+    // 每滚动一格移动一个窗口
+    const QPoint delta = e->angleDelta();
+    m_wheelDelta += delta.y() != 0 ? delta.y() : delta.x();
+
+    const int steps = m_wheelDelta / QWheelEvent::DefaultDeltasPerStep;
+    if (steps == 0)
+        return;
+
+    m_wheelDelta -= steps * QWheelEvent::DefaultDeltasPerStep;
+    scrollTo(m_firstIndex - steps);
+    fetchStaleSnapshots();
+}
+
+void PreviewContainer::onSnapshotReady(const WId wid)
+{
+    // 跟随的窗口换了截图时更新浮动预览
+    if (m_floatingPreview->isVisible() && wid == m_currentWId)
+        m_floatingPreview->update();
+
+    // 只记录每次弹出预览后的第一张缩略图
+    if (!m_firstThumbnailTimer.isValid())
+        return;
+
+    qCDebug(previewLog) << "first thumbnail after" << m_firstThumbnailTimer.elapsed() << "ms," << m_windowList.size() << "windows";
+    m_firstThumbnailTimer.invalidate();
 }
 
 void PreviewContainer::enterEvent(QEvent *e)
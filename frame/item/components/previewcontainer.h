@@ -25,6 +25,8 @@
 #include <QWidget>
 #include <QBoxLayout>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
 
 #include "../../interfaces/constants.h"
 #include "../../taskmanager/windowinfomap.h"
@@ -35,13 +37,15 @@
 
 DWIDGET_USE_NAMESPACE
 
+class QScreen;
+
 class PreviewContainer : public QWidget
 {
     Q_OBJECT
 
 public:
     static PreviewContainer* instance();
-    static PreviewContainer* instance(const WindowInfoMap &infos, const QVector<uint> allowClose, const Dock::Position dockPos);
+    static PreviewContainer* instance(const WindowInfoMap &infos, const QVector<uint> allowClose, const Dock::Position dockPos, QScreen *screen);
 
 signals:
     void requestActivateWindow(const WId wid) const;
@@ -53,6 +57,11 @@ signals:
 public:
     void setWindowInfos(const WindowInfoMap &infos, const QVector<uint> allowClose);
     void updateSnapshots();
+    void updateWindowInfo(const WId wid, const WindowInfo &info);
+    void removeWindowInfo(const WId wid);
+
+    // count个窗口在screen上沿给定方向最多能同时显示几个，其余的通过滚动查看
+    static int visibleSnapshotCount(const int count, const Qt::Orientation orientation, const QScreen *screen);
 
 public slots:
     void updateLayoutDirection(const Dock::Position dockPos);
@@ -62,21 +71,32 @@ public slots:
 private:
     explicit PreviewContainer();
     void adjustSize();
-    void appendSnapWidget(const WId wid);
+    void appendSnapWidget();
+    void updateSnapWidgets();
+    void fetchStaleSnapshots();
+    void scrollTo(int index);
 
     void enterEvent(QEvent *e);
     void leaveEvent(QEvent *e);
     void dragEnterEvent(QDragEnterEvent *e);
     void dragLeaveEvent(QDragLeaveEvent *e);
+    void wheelEvent(QWheelEvent *e);
 
 private slots:
     void onSnapshotClicked(const WId wid);
     void previewEntered(const WId wid);
     void previewFloating();
+    void onSnapshotReady(const WId wid);
 
 private:
     bool m_needActivate;
-    QMap<WId, AppSnapshot *> m_snapshots;
+    QList<WId> m_windowList;            // 所有窗口，按显示顺序
+    WindowInfoMap m_windowInfos;
+    QVector<uint> m_allowClose;
+    QList<AppSnapshot *> m_snapshots;   // 只为能显示出来的位置创建控件，滚动时复用
+    QList<AppSnapshot *> m_staleSnapshots;  // 换了窗口、尚未重新截图的控件
+    int m_firstIndex;                   // 第一个控件显示的窗口在m_windowList中的位置
+    int m_wheelDelta;
 
     FloatingPreview *m_floatingPreview;
     QBoxLayout *m_windowListLayout;
@@ -85,6 +105,8 @@ private:
     DWindowManagerHelper *m_wmHelper;
     QTimer *m_waitForShowPreviewTimer;
     WId m_currentWId;
+    QPointer<QScreen> m_screen;         // 预览弹出的屏幕，决定能同时显示几个窗口
+    QElapsedTimer m_firstThumbnailTimer;    // 弹出预览后到第一张缩略图之间计时
 };
 
 #endif // PREVIEWCONTAINER_H
@@ -1,9 +1,8 @@
 #include "diritem.h"
 #include "window/dockitemmanager.h"
+#include "window/docklayout.h"
 #include "util/dockpopupwindow.h"
 
-#include <QPen>
-
 static DockPopupWindow *dirPopupWindow(nullptr);
 
 DirItem::DirItem(QString title, QWidget *parent) : DockItem(parent)
@@ -53,7 +52,12 @@ bool DirItem::hasId(QString id)
 
 int DirItem::getIndex()
 {
-    return parentWidget() ? parentWidget()->layout()->itemAt(1)->layout()->indexOf(this) : (m_index ? m_index : -1);
+    // 已加入任务栏时返回在所在区域中的位置
+    DockLayout *layout = parentWidget() ? qobject_cast<DockLayout *>(parentWidget()->layout()) : nullptr;
+    if (DockArea *area = layout ? layout->areaOf(this) : nullptr)
+        return area->indexOf(this);
+
+    return m_index ? m_index : -1;
 }
 
 void DirItem::setIndex(int index)
@@ -131,40 +135,22 @@ void DirItem::paintEvent(QPaintEvent *e)
     DockItem::paintEvent(e);
 
     QPainter painter(this);
-    painter.setPen(QPen(Qt::darkCyan, 2));
-    // painter.setOpacity(.7);
-
-    QRect border = rect().adjusted(2, 2, -2, -2);
-    QRect line(3, 3, border.width()-2, border.height()-2);
-    painter.setRenderHint(QPainter::Antialiasing);
-    painter.drawRoundedRect(line, 6, 6, Qt::AbsoluteSize);
-
-    // painter.setOpacity(.9);
-
-    int padding = 8;
-    int spacing = 4;
-    qreal w = (rect().width() - spacing) / 2 - padding;
-    int i = 0;
-    for(auto appItem : m_appList)
-    {
-        QPixmap pixmap = appItem->appIcon();
-
-        QRect appRect;
+    // 悬停等动画只需重绘背景，集合的图标沿用上次生成的结果
+    painter.drawPixmap(0, 0, m_composite.pixmap(size(), devicePixelRatioF(), compositeMembers()));
+}
 
-        if(i == 0)
-            appRect = QRect(padding, padding, w, w);
-        else if (i == 1)
-            appRect = QRect(padding + w + spacing, padding, w, w);
-        else if (i == 2)
-            appRect = QRect(padding, padding + w + spacing, w, w);
-        else if (i == 3)
-            appRect = QRect(padding + w + spacing, padding + w + spacing, w, w);
+QString DirItem::paintKey() const
+{
+    return DockItem::paintKey() + ":" + DirComposite::key(size(), devicePixelRatioF(), compositeMembers());
+}
 
-        painter.drawPixmap(appRect, pixmap);
+QList<DirComposite::Member> DirItem::compositeMembers() const
+{
+    QList<DirComposite::Member> members;
+    for (auto appItem : m_appList.mid(0, DirComposite::MaxMembers))
+        members.append(DirComposite::Member{appItem->icon(), appItem->width()});
 
-        if(++i == 4)
-            break;
-    }
+    return members;
 }
 
 void DirItem::leaveEvent(QEvent *e)
@@ -5,6 +5,7 @@
 #include "appitem.h"
 #include "tipswidget.h"
 #include "components/AppDirWidget.h"
+#include "components/dircomposite.h"
 
 class AppItem;
 class AppDirWidget;
@@ -42,6 +43,7 @@ public:
     AppItem *lastItem();
 
     Place getPlace() override { return DockPlace; }
+    QString paintKey() const override;
 
 protected:
     void paintEvent(QPaintEvent *e) override;
@@ -54,6 +56,9 @@ protected:
 
     void showDirPopupWindow();
 
+private:
+    QList<DirComposite::Member> compositeMembers() const;
+
 public slots:
     void hideDirpopupWindow();
 
@@ -67,6 +72,8 @@ private:
     QSet<QString> m_ids;
     QList<AppItem *> m_appList;
 
+    DirComposite m_composite;   // 边框与前四个成员的图标，成员、图标、大小或缩放比变化时重新生成
+
     friend class AppItem;
 };
 
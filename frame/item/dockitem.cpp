@@ -25,8 +25,10 @@
 #include "../window/dockitemmanager.h"
 #include "components/hoverhighlighteffect.h"
 #include "components/appeffect.h"
+#include "util/utils.h"
 
 #include <QMouseEvent>
+#include <QGuiApplication>
 #include <QJsonObject>
 #include <QCursor>
 
@@ -51,11 +53,18 @@ DockItem::DockItem(QWidget *parent) : QWidget(parent)
     m_popupTipsDelayTimer->setInterval(500);
     m_popupTipsDelayTimer->setSingleShot(true);
 
+    // 高亮结果按paintKey()复用
+    auto highlightEffect = [this] {
+        HoverHighlightEffect *effect = new HoverHighlightEffect(this);
+        effect->setKeyFunction([this] { return paintKey(); });
+        return effect;
+    };
+
     if(DockItemManager::instance()->isEnableHoverHighlight())
-        setGraphicsEffect(new HoverHighlightEffect(this));
+        setGraphicsEffect(highlightEffect());
 
-    connect(DockItemManager::instance(), &DockItemManager::hoverHighlighted, this, [this](const bool enabled){
-        setGraphicsEffect(enabled ? new HoverHighlightEffect(this) : nullptr);
+    connect(DockItemManager::instance(), &DockItemManager::hoverHighlighted, this, [this, highlightEffect](const bool enabled){
+        setGraphicsEffect(enabled ? highlightEffect() : nullptr);
     });
 
     connect(m_popupTipsDelayTimer, &QTimer::timeout, this, &DockItem::showHoverTips);
@@ -87,6 +96,12 @@ void DockItem::paintEvent(QPaintEvent *e)
     painter.drawPixmap(iconX, iconY, pixmap);
 }
 
+QString DockItem::paintKey() const
+{
+    return QString("%1:%2x%3@%4:%5").arg(m_icon.cacheKey()).arg(width()).arg(height())
+            .arg(devicePixelRatioF()).arg(m_animation != nullptr);
+}
+
 void DockItem::mousePressEvent(QMouseEvent *e)
 {
     m_popupTipsDelayTimer->stop();
@@ -108,7 +123,9 @@ void DockItem::enterEvent(QEvent *e)
         if(m_animation)
             m_animation->setDirection(QVariantAnimation::Forward);
         else {
-            m_animation = AppEffect::PopupEffect(this, (m_icon.isNull() || itemType() == Window) ? grab() : m_icon.pixmap(width() *.9), DockPosition);
+            QString cacheKey;
+            const QPixmap icon = effectIcon(&cacheKey);
+            m_animation = AppEffect::PopupEffect(this, icon, DockPosition, cacheKey);
             connect(m_animation, &QVariantAnimation::stateChanged, this, [this](const QVariantAnimation::State newState, const QVariantAnimation::State oldState) {
                 if(newState == QVariantAnimation::Running)
                     update();
@@ -269,6 +286,12 @@ const QPoint DockItem::popupMarkPoint()
     return p;
 }
 
+QScreen *DockItem::popupScreen()
+{
+    QScreen *screen = Utils::screenAtByScaled(popupMarkPoint());
+    return screen ? screen : QGuiApplication::primaryScreen();
+}
+
 const QPoint DockItem::topleftPoint() const
 {
     QPoint p;
@@ -290,11 +313,25 @@ void DockItem::hidePopup()
         emit requestWindowAutoHide(true);
 }
 
+QPixmap DockItem::effectIcon(QString *cacheKey)
+{
+    if (m_icon.isNull() || itemType() == Window) {
+        cacheKey->clear();
+        return grab();
+    }
+
+    const QPixmap icon = m_icon.pixmap(width() * .9);
+    *cacheKey = AppEffect::iconKey(m_icon, icon);
+    return icon;
+}
+
 void DockItem::easeIn(bool animation)
 {
     if(animation && DockItemManager::instance()->isEnableInOutAnimation()) {
         if(m_animation) m_animation->stop();
-        m_animation = AppEffect::ScaleEffect(this, (m_icon.isNull() || itemType() == Window) ? grab() : m_icon.pixmap(width() *.9), DockPosition);
+        QString cacheKey;
+        const QPixmap icon = effectIcon(&cacheKey);
+        m_animation = AppEffect::ScaleEffect(this, icon, DockPosition, cacheKey);
         connect(m_animation, &QVariantAnimation::stateChanged, this, [this](const QVariantAnimation::State newState, const QVariantAnimation::State oldState) {
             if(newState == QVariantAnimation::Running)
                 update();
@@ -313,7 +350,9 @@ void DockItem::easeOut(bool animation)
 {
     if(animation && DockItemManager::instance()->isEnableInOutAnimation()) {
         if(m_animation) m_animation->stop();
-        m_animation = AppEffect::ScaleEffect(this, (m_icon.isNull() || itemType() == Window) ? grab() : m_icon.pixmap(width() *.9), DockPosition);
+        QString cacheKey;
+        const QPixmap icon = effectIcon(&cacheKey);
+        m_animation = AppEffect::ScaleEffect(this, icon, DockPosition, cacheKey);
         m_animation->setDirection(QAbstractAnimation::Backward);
         connect(m_animation, &QVariantAnimation::stateChanged, this, [this](const QVariantAnimation::State newState, const QVariantAnimation::State oldState) {
             if(newState == QVariantAnimation::Running)
@@ -28,6 +28,8 @@
 #include <QPointer>
 #include <QMenu>
 
+class QScreen;
+
 using namespace Dock;
 class DockItem : public QWidget
 {
@@ -60,6 +62,9 @@ public:
     void easeIn(bool animation);
     void easeOut(bool animation);
 
+    // 标识当前绘制的内容，内容不变时结果不变，悬停高亮据此复用上次的计算结果
+    virtual QString paintKey() const;
+
 signals:
     void itemDropped(QObject *destination, const QPoint &dropPoint) const;
     void requestWindowAutoHide(const bool autoHide) const;
@@ -73,6 +78,8 @@ protected:
 
     const QRect perfectIconRect() const;
     virtual const QPoint popupMarkPoint() ;
+    // 弹窗所在的屏幕，找不到时为主屏
+    QScreen *popupScreen();
     const QPoint topleftPoint() const;
 
     void hideNonModel();
@@ -92,6 +99,10 @@ protected:
     static Position DockPosition;
     QIcon m_icon;
 
+private:
+    // 动画使用的图标，没有图标或是窗口项时为控件截图，cacheKey为空表示结果不能缓存
+    QPixmap effectIcon(QString *cacheKey);
+
 private:
     QVariantAnimation *m_animation;
 };
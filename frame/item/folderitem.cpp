@@ -1,187 +1,152 @@
 #include "folderitem.h"
 
 #include "util/dockpopupwindow.h"
+#include "components/foldermodel.h"
 
 #include <QMouseEvent>
 #include <QGuiApplication>
 #include <QClipboard>
 #include <QStyleOption>
 #include <DGuiApplicationHelper>
-#include <QListWidget>
+#include <QListView>
+#include <QStyledItemDelegate>
 #include <QScrollBar>
-#include <QFileIconProvider>
-#include <QFileSystemWatcher>
 #include <QStandardPaths>
+#include <QToolTip>
+#include <QProcess>
+#include <QTimer>
+#include <QMimeData>
+#include <QFile>
+#include <QFileInfo>
+#include <QUrl>
+#include <QPainter>
+#include <QHelpEvent>
 
 static DockPopupWindow *dirPopupWindow(nullptr);
-static QFileIconProvider provider;
 
-class FolderWidget;
-class DesktopItemView : public QWidget {
-    Q_OBJECT
-public:
-    DesktopItemView(const QString &file, QWidget *parent) : QWidget(parent)
-    , m_current(false)
-    {
-        m_path = file;
-
-        QVBoxLayout *layout = new QVBoxLayout(this);
-        layout->setSpacing(5);
-        layout->setContentsMargins(10, 10, 10, 10);
-        QLabel *iconLabel = new QLabel(this);
-        iconLabel->setFixedSize(50, 50);
-        iconLabel->setScaledContents(true);
-        iconLabel->setAlignment(Qt::AlignCenter);
-        iconLabel->setPixmap(provider.icon(QFileInfo(file)).pixmap(70, 70));
-        layout->addWidget(iconLabel, 0, Qt::AlignCenter);
-
-        QLabel *titleLabel = new QLabel(this);
-        titleLabel->setFixedSize(80, 25);
-        titleLabel->setAlignment(Qt::AlignCenter);
-        QFont font = titleLabel->font();
-        font.setBold(true);
-        titleLabel->setFont(font);
-        const QString fileName = QFileInfo(m_path).fileName();
-        QString txt = titleLabel->fontMetrics().elidedText(fileName, Qt::ElideRight, titleLabel->width());
-        if(txt != fileName) setToolTip(fileName);
-        titleLabel->setText(txt);
-        layout->addWidget(titleLabel);
-
-        setFixedSize(100, 100);
-        setMouseTracking(true);
+// 每个文件所占的区域与其中图标、文件名的位置
+static const QSize ItemSize(100, 100);
+static const QRect IconRect(25, 10, 50, 50);
+static const QRect TitleRect(10, 65, 80, 25);
 
-        currentChanged(false, false);
-    }
+/**
+ * @brief The FolderItemDelegate class 绘制单个文件：圆角背景、图标和加粗的文件名，代替原来每个文件一个控件
+ */
+class FolderItemDelegate : public QStyledItemDelegate {
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override {
+        const bool current = option.state & QStyle::State_Selected;
+        const bool hover = option.state & QStyle::State_MouseOver;
+        const QRect rect(option.rect.topLeft(), ItemSize);
+
+        painter->save();
+        painter->setRenderHint(QPainter::Antialiasing);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(color(current, hover));
+        painter->drawRoundedRect(rect, 10, 10);
+
+        const QPixmap pixmap = index.data(Qt::DecorationRole).value<QPixmap>();
+        if (!pixmap.isNull()) {
+            // 缩略图保持比例，居中显示
+            QSize size = pixmap.size() / pixmap.devicePixelRatioF();
+            size.scale(IconRect.size(), Qt::KeepAspectRatio);
+            QRect iconRect(QPoint(), size);
+            iconRect.moveCenter(IconRect.translated(rect.topLeft()).center());
+            painter->setRenderHint(QPainter::SmoothPixmapTransform);
+            painter->drawPixmap(iconRect, pixmap);
+        }
 
-    void open() {
-        QProcess::startDetached("xdg-open", {m_path});
+        QFont font = option.font;
+        font.setBold(true);
+        painter->setFont(font);
+        painter->setPen(current ? option.palette.highlight().color() : option.palette.windowText().color());
+        painter->drawText(TitleRect.translated(rect.topLeft()), Qt::AlignCenter, elidedName(font, index));
+        painter->restore();
     }
 
-    void currentChanged(bool current, bool hover=false) {
-        m_current = current;
-        setStyleSheet(QString("QLabel {color: %1} DesktopItemView { background-color: %2; border-radius: 10px; }")
-                    .arg(m_current ? palette().highlight().color().name() : palette().windowText().color().name())
-                    .arg(color(current, hover)));
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override {
+        Q_UNUSED(option)
+        Q_UNUSED(index)
+        return ItemSize;
     }
 
+    bool helpEvent(QHelpEvent *event, QAbstractItemView *view, const QStyleOptionViewItem &option, const QModelIndex &index) override {
+        // 只有文件名显示不全时才提示完整的名称
+        if (event->type() == QEvent::ToolTip) {
+            QFont font = option.font;
+            font.setBold(true);
+            const QString fileName = index.data(Qt::DisplayRole).toString();
+            if (elidedName(font, index) != fileName)
+                QToolTip::showText(event->globalPos(), fileName, view);
+            else
+                QToolTip::hideText();
+            return true;
+        }
 
-protected:
-    void enterEvent(QEvent *event) override {
-        if(!m_current)
-            currentChanged(m_current, true);
-        QWidget::enterEvent(event);
-    }
-
-    void leaveEvent(QEvent *event) override {
-        if(!m_current)
-            currentChanged(m_current, false);
-        QWidget::leaveEvent(event);
+        return QStyledItemDelegate::helpEvent(event, view, option, index);
     }
 
-    void paintEvent(QPaintEvent *event) override
-    {
-        Q_UNUSED(event)
-        QStyleOption opt;
-        opt.init(this);
-        QPainter p(this);
-        style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+private:
+    static QString elidedName(const QFont &font, const QModelIndex &index) {
+        return QFontMetrics(font).elidedText(index.data(Qt::DisplayRole).toString(), Qt::ElideRight, TitleRect.width());
     }
 
-private:
-    QString color(bool on, bool hover) {
+    static QColor color(bool on, bool hover) {
+        const qreal alpha = on ? .4 : (hover ? .3 : .2);
         if(DGuiApplicationHelper::instance()->themeType() == DGuiApplicationHelper::LightType)
-            return QString("rgba(0, 0, 0, %1)").arg(on ? "40%" : (hover ? "30%" : "20%"));
+            return QColor(0, 0, 0, 255 * alpha);
         else
-            return QString("rgba(255,255,255, %1)").arg(on ? "40%" : (hover ? "30%" : "20%"));
+            return QColor(255, 255, 255, 255 * alpha);
     }
-
-private:
-    QString m_path;
-    bool m_current;
-
-    friend class FolderWidget;
 };
 
-class FolderWidget : public QListWidget {
+class FolderWidget : public QListView {
     Q_OBJECT
 public:
-    FolderWidget(QString path) : QListWidget()
+    FolderWidget(QString path) : QListView()
     , m_path(path)
     , m_mouseLeaveTimer(new QTimer(this))
-    , m_watcher(new QFileSystemWatcher({path}, this))
+    , m_model(new FolderModel(path, this))
     {
-        setFlow(QListWidget::LeftToRight);
-        setViewMode(QListWidget::IconMode);
+        setFlow(QListView::LeftToRight);
+        setViewMode(QListView::IconMode);
         setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
         setResizeMode(QListView::Adjust);
-        setSelectionBehavior(QListWidget::SelectItems);
-        setSelectionMode(QListWidget::SingleSelection);
+        setSelectionBehavior(QListView::SelectItems);
+        setSelectionMode(QListView::SingleSelection);
         setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
         setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-        setVerticalScrollMode(QListWidget::ScrollPerPixel);
-        setDragDropMode(QListWidget::DragDrop);
+        setVerticalScrollMode(QListView::ScrollPerPixel);
+        setDragDropMode(QListView::DragOnly);
         setUniformItemSizes(true);
         setMouseTracking(true);
+        viewport()->setAttribute(Qt::WA_Hover);
         verticalScrollBar()->setSingleStep(30);
 
         setSpacing(30);
         setContentsMargins(30, 10, 30, 10);
 
-        connect(this, &FolderWidget::itemClicked, [this](QListWidgetItem *item){
-            qobject_cast<DesktopItemView*>(itemWidget(item))->open();
-        });
+        setItemDelegate(new FolderItemDelegate(this));
+        setModel(m_model);
 
-        connect(this, &FolderWidget::currentItemChanged, this, [this](QListWidgetItem *current, QListWidgetItem *prev){
-            if(current)
-                if(DesktopItemView *v = qobject_cast<DesktopItemView*>(itemWidget(current)))
-                    v->currentChanged(true);
-            if(prev)
-                if(DesktopItemView *v = qobject_cast<DesktopItemView*>(itemWidget(prev)))
-                    v->currentChanged(false);
+        connect(this, &FolderWidget::clicked, [](const QModelIndex &index){
+            QProcess::startDetached("xdg-open", {index.data(FolderModel::FilePathRole).toString()});
         });
 
-        connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, [this]{
-            const int current = currentRow();
-            for(int i=0, len=count(); i<len; i++)
-                qobject_cast<DesktopItemView*>(itemWidget(item(i)))->currentChanged(current == i);
-        });
+        connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, viewport(), static_cast<void (QWidget::*)()>(&QWidget::update));
 
         m_mouseLeaveTimer->setSingleShot(true);
         m_mouseLeaveTimer->setInterval(100);
 
         connect(m_mouseLeaveTimer, &QTimer::timeout, this, &FolderWidget::checkMouseLeave);
-        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &FolderWidget::refresh);
-        refresh();
     }
 
     ~FolderWidget() {
         // m_watcher->cancel();
     }
 
-    void refresh() {
-        clear();
-
-        QDir dir(m_path);
-
-        if(!dir.exists() || dir.isEmpty(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot)) return;
-
-        for(auto file : dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot)) {
-            QListWidgetItem *item = new QListWidgetItem(this);
-            item->setSizeHint(QSize(100, 100));
-            this->addItem(item);
-
-            DesktopItemView *desktopItemView = new DesktopItemView(file.absoluteFilePath(), this);
-            this->setItemWidget(item, desktopItemView);
-        }
-    }
-
-    void clear() {
-        while(QListWidgetItem *item = takeItem(0)) {
-            itemWidget(item)->deleteLater();
-            delete item;
-        }
-    }
-
     void prepareHide()
     {
         m_mouseLeaveTimer->start();
@@ -204,27 +169,13 @@ public:
         m_mouseLeaveTimer->start();
     }
 
-    QStringList mimeTypes() const {
-        return QStringList("text/uri-list");
-    }
-
-    QMimeData *mimeData(const QList<QListWidgetItem *> items) const {
-        QMimeData *data = new QMimeData();
-        QList<QUrl> urls;
-        for(auto item : items)
-            urls << QUrl::fromLocalFile(qobject_cast<DesktopItemView*>(itemWidget(item))->m_path);
-
-        data->setUrls(urls);
-        return data;
-    }
-
 signals:
     void requestHidePopup();
 
 private:
     QString m_path;
     QTimer *m_mouseLeaveTimer;
-    QFileSystemWatcher *m_watcher;
+    FolderModel *m_model;
 };
 
 FolderItem::FolderItem(QString path, QWidget *parent) : DockItem(parent)
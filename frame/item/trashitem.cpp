@@ -1,6 +1,7 @@
 #include "trashitem.h"
 
 #include "util/utils.h"
+#include "util/trashmonitor.h"
 
 #include <QPainter>
 #include <QProcess>
@@ -10,7 +11,6 @@
 #include <QStandardPaths>
 #include <DDesktopServices>
 #include <QMessageBox>
-#include <QFileSystemWatcher>
 
 static const QString TRASHPATH = QStandardPaths::writableLocation(QStandardPaths::HomeLocation) + "/.local/share/Trash";
 static const QString TRASHEXPUNGED = TRASHPATH + "/expunged";
@@ -18,10 +18,11 @@ static const QString TRASHFILE = TRASHPATH + "/files";
 static const QString TRASHINFO = TRASHPATH + "/info";
 
 TrashItem::TrashItem(QWidget *parent) : DockItem(parent)
-    , m_watcher(new QFileSystemWatcher({TRASHFILE}, this))
+    , m_monitor(new TrashMonitor(TRASHPATH, this))
+    , m_count(-1)
 {
     setAcceptDrops(true);
-    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &TrashItem::refershIcon);
+    connect(m_monitor, &TrashMonitor::countChanged, this, &TrashItem::refershIcon);
     refershIcon();
 }
 
@@ -31,14 +32,14 @@ QString TrashItem::popupTips() {
 
 void TrashItem::refershIcon()
 {
-    QDir dir(TRASHFILE);
-    dir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot);
-    if (dir.exists() == false or dir.isEmpty()) {
-        m_icon = QIcon::fromTheme("user-trash");
-        m_count = 0;
-    } else {
-        m_icon = QIcon::fromTheme("user-trash-full");
-        m_count = dir.count();
+    // 项目数由m_monitor维护，这里不再遍历目录，只在空与非空切换时更换图标
+    const int count = m_monitor->count();
+    const bool changeIcon = m_count == -1 || (m_count == 0) != (count == 0);
+    m_count = count;
+
+    if (changeIcon) {
+        m_icon = QIcon::fromTheme(m_count == 0 ? "user-trash" : "user-trash-full");
+        update();
     }
 }
 
@@ -89,14 +90,13 @@ void TrashItem::invokedMenuItem(const QString &itemId, const bool checked)
     {
         if (QMessageBox::Ok == QMessageBox::warning(this, "警告", "清空后数据将不可恢复！\n确认清空回收站？", QMessageBox::Cancel | QMessageBox::Ok, QMessageBox::Ok))
         {
-            m_watcher->blockSignals(true);
             QProcess::execute("rm", {"-r", TRASHFILE, TRASHINFO});
             QDir dir(TRASHPATH);
             dir.mkdir("files");
             dir.mkdir("info");
             Dtk::Widget::DDesktopServices::playSystemSoundEffect(Dtk::Widget::DDesktopServices::SSE_EmptyTrash);
-            refershIcon();
-            m_watcher->blockSignals(false);
+            // files目录被整个重建，直接重新统计，不必等待inotify事件
+            m_monitor->rescan();
         }
     }
 }
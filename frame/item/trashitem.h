@@ -3,6 +3,8 @@
 
 #include "dockitem.h"
 
+class TrashMonitor;
+
 class TrashItem : public DockItem
 {
     Q_OBJECT
@@ -24,7 +26,7 @@ protected:
     const QString contextMenu() const Q_DECL_OVERRIDE;
 
 private:
-    QFileSystemWatcher *m_watcher;
+    TrashMonitor *m_monitor;   // 按inotify事件增量维护回收站中的项目数
     int m_count;
 };
 
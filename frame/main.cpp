@@ -23,6 +23,7 @@
 #include "window/dockitemmanager.h"
 #include "dbus/dbusdockadaptors.h"
 #include "dbus/dockdaemonadaptors.h"
+#include "util/frameclock.h"
 #include <QDir>
 #include <DApplication>
 #include <DLog>
@@ -72,6 +73,9 @@ int main(int argc, char *argv[])
     app.loadTranslator();
     app.setAttribute(Qt::AA_UseHighDpiPixmaps, false);
 
+    // 所有动画共用按屏幕刷新率计时的帧时钟
+    FrameClock::instance();
+
     DLogManager::setLogFormat("%{time}{yyyyMMdd.HH:mm:ss.zzz}[%{type:1}][%{function:-35} %{line:-4}] %{message}\n");
     DLogManager::registerConsoleAppender();
     DLogManager::registerFileAppender();
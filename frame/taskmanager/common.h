@@ -26,6 +26,7 @@ const QString keyForceQuitApp         = "Force_Quit_App";
 const QString keyShowMultiWindow      = "Show_MultiWindow";
 const QString keyWindowSizeFashion    = "Window_Size_Fashion";
 const QString keyWinIconPreferredApps = "Win_Icon_Preferred_Apps";
+const QString keySnapshotMemoryBudget = "Snapshot_Memory_Budget";
 
 const QString keyShowWindowName      = "Dock_Show_Window_Name";
 
@@ -52,6 +53,7 @@ const int smartHideTimerDelay           = 400;
 const int configureNotifyDelay          = 100;
 
 const int bestIconSize                  = 48;
+const int dockIconSize                  = 85;   // 任务栏绘制应用图标的尺寸，与AppItem::refreshIcon一致
 const int menuItemHintShowAllWindows    = 1;
 
 const int MotifHintStatus               = 8;
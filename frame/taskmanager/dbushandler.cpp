@@ -136,8 +136,11 @@ void DBusHandler::listenKWindowSignals(WindowInfoK *windowInfo)
     connect(window, &PlasmaWindow::TitleChanged, this, [=] {
         windowInfo->updateTitle();
         auto entry = m_taskmanager->getEntryByWindowId(windowInfo->getXid());
-        if (entry && entry->getCurrentWindowInfo() == windowInfo)
+        if (!entry) return;
+
+        if (entry->getCurrentWindowInfo() == windowInfo)
             entry->updateName();
+        entry->updateExportWindowInfo(windowInfo);
     });
     connect(window, &PlasmaWindow::IconChanged, this, [=] {
         windowInfo->updateIcon();
@@ -153,7 +156,7 @@ void DBusHandler::listenKWindowSignals(WindowInfoK *windowInfo)
         auto entry = m_taskmanager->getEntryByWindowId(windowInfo->getXid());
         if (!entry) return;
 
-        entry->updateExportWindowInfos();
+        entry->updateExportWindowInfo(windowInfo);
     });
 
     // Geometry changed
@@ -10,6 +10,7 @@
 #include "windowinfomap.h"
 
 #include <QDebug>
+#include <QTimer>
 #include <QDBusInterface>
 
 #include <algorithm>
@@ -22,6 +23,7 @@ Entry::Entry(TaskManager *_taskmanager, AppInfo *_app, QString _innerId, QObject
     , m_isActive(false)
     , m_isDocked(false)
     , m_winIconPreferred(false)
+    , m_windowInfosChangedPending(false)
     , m_innerId(_innerId)
     , m_adapterEntry(nullptr)
     , m_taskmanager(_taskmanager)
@@ -104,6 +106,21 @@ QString Entry::getIcon()
     return ret;
 }
 
+/**
+ * @brief Entry::getWindowIcon 当前显示的是窗口自带图标时返回其原始像素，否则返回空
+ * @return
+ */
+WindowIcon Entry::getWindowIcon()
+{
+    if (!hasWindow() || !m_current)
+        return WindowIcon();
+
+    if (!m_winIconPreferred && m_appInfo && !m_appInfo->getIcon().isEmpty())
+        return WindowIcon();
+
+    return m_current->getWindowIcon();
+}
+
 QString Entry::getInnerId()
 {
     return m_innerId;
@@ -194,7 +211,24 @@ void Entry::updateMenu()
 
 void Entry::updateIcon()
 {
-    setPropIcon(getIcon());
+    const WindowIcon windowIcon = getWindowIcon();
+    if (windowIcon.isNull()) {
+        if (!m_windowIcon.isNull()) {
+            m_windowIcon = WindowIcon();
+            m_icon = getIcon();
+            Q_EMIT iconChanged(m_icon);
+            return;
+        }
+
+        setPropIcon(getIcon());
+        return;
+    }
+
+    if (windowIcon != m_windowIcon || !m_icon.isEmpty()) {
+        m_windowIcon = windowIcon;
+        m_icon.clear();
+        Q_EMIT iconChanged(m_icon);
+    }
 }
 
 int Entry::getCurrentMode()
@@ -223,7 +257,8 @@ void Entry::updateMode()
 
 void Entry::forceUpdateIcon()
 {
-    m_icon = getIcon();
+    m_windowIcon = getWindowIcon();
+    m_icon = m_windowIcon.isNull() ? getIcon() : QString();
     Q_EMIT iconChanged(m_icon);
 }
 
@@ -347,40 +382,89 @@ bool Entry::hasWindow()
 }
 
 /**
- * @brief Entry::updateExportWindowInfos 同步更新导出窗口信息
+ * @brief Entry::updateExportWindowInfos 同步更新全部导出窗口信息，按窗口发送增量变化
  */
 void Entry::updateExportWindowInfos()
 {
-    WindowInfoMap infos;
-    for (auto info : m_windowInfoMap) {
-        WindowInfo winInfo;
-        XWindow xid = info->getXid();
-        winInfo.title = info->getTitle();
-        winInfo.attention = info->isDemandingAttention();
-        winInfo.uuid = info->uuid();
-        infos[xid] = winInfo;
-    }
-
-    bool changed = true;
-    if (infos.size() == m_exportWindowInfos.size()) {
-        changed = false;
-        for (auto iter = infos.begin(); iter != infos.end(); iter++) {
-            XWindow xid = iter.key();
-            if (infos[xid].title != m_exportWindowInfos[xid].title ||
-                    infos[xid].attention != m_exportWindowInfos[xid].attention ||
-                    infos[xid].uuid != m_exportWindowInfos[xid].uuid) {
-                changed = true;
-                break;
-            }
-        }
+    QList<XWindow> removed;
+    for (auto iter = m_exportWindowInfos.cbegin(); iter != m_exportWindowInfos.cend(); iter++) {
+        if (!m_windowInfoMap.contains(iter.key()))
+            removed.push_back(iter.key());
     }
 
-    if (changed) {
-        Q_EMIT windowInfosChanged(infos);
+    for (XWindow xid : removed)
+        removeExportWindowInfo(xid);
+
+    for (auto info : m_windowInfoMap)
+        updateExportWindowInfo(info);
+}
+
+/**
+ * @brief Entry::updateExportWindowInfo 只刷新单个窗口的导出信息（标题、提醒状态等）
+ * @param info
+ */
+void Entry::updateExportWindowInfo(WindowInfoBase *info)
+{
+    if (!info || !m_windowInfoMap.contains(info->getXid()))
+        return;
+
+    XWindow xid = info->getXid();
+    WindowInfo winInfo;
+    winInfo.title = info->getTitle();
+    winInfo.attention = info->isDemandingAttention();
+    winInfo.uuid = info->uuid();
+
+    auto iter = m_exportWindowInfos.find(xid);
+    if (iter == m_exportWindowInfos.end()) {
+        m_exportWindowInfos.insert(xid, winInfo);
+        Q_EMIT windowInfoAdded(xid, winInfo);
+        Q_EMIT m_taskmanager->windowInfoAdded(m_id, xid, winInfo.title, winInfo.attention);
+        requestWindowInfosChanged();
+        return;
+    }
+
+    if (iter.value() == winInfo)
+        return;
+
+    const WindowInfo oldInfo = iter.value();
+    iter.value() = winInfo;
+
+    if (oldInfo.title != winInfo.title) {
+        Q_EMIT windowTitleChanged(xid, winInfo.title);
+        Q_EMIT m_taskmanager->windowTitleChanged(m_id, xid, winInfo.title);
     }
 
-    // 更新导出的窗口信息
-    m_exportWindowInfos = infos;
+    if (oldInfo.attention != winInfo.attention) {
+        Q_EMIT windowAttentionChanged(xid, winInfo.attention);
+        Q_EMIT m_taskmanager->windowAttentionChanged(m_id, xid, winInfo.attention);
+    }
+
+    requestWindowInfosChanged();
+}
+
+void Entry::removeExportWindowInfo(XWindow xid)
+{
+    if (!m_exportWindowInfos.remove(xid))
+        return;
+
+    Q_EMIT windowInfoRemoved(xid);
+    Q_EMIT m_taskmanager->windowInfoRemoved(m_id, xid);
+    requestWindowInfosChanged();
+}
+
+/**
+ * @brief Entry::requestWindowInfosChanged 完整窗口列表信号仅为兼容保留，同一轮事件循环内合并为一次发送
+ */
+void Entry::requestWindowInfosChanged()
+{
+    if (m_windowInfosChangedPending)
+        return;
+
+    m_windowInfosChangedPending = true;
+    QTimer::singleShot(0, this, [this] {
+        m_windowInfosChangedPending = false;
+        Q_EMIT windowInfosChanged(m_exportWindowInfos);
+    });
 }
 
 // 分离窗口， 返回是否需要从任务栏remove
@@ -399,7 +483,6 @@ bool Entry::detachWindow(WindowInfoBase *info)
             return true;
         }
 
-        Q_EMIT windowInfosChanged(WindowInfoMap());
         setCurrentWindowInfo(nullptr);
     } else {
         for (auto window : m_windowInfoMap) {
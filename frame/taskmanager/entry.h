@@ -40,6 +40,7 @@ public:
     void updateIsActive();
     void forceUpdateIcon();
     void updateExportWindowInfos();
+    void updateExportWindowInfo(WindowInfoBase *info);
     void launchApp(uint32_t timestamp);
 
     void setIsDocked(bool value);
@@ -80,6 +81,7 @@ public:
 
     QString getName();
     QString getIcon();
+    WindowIcon getWindowIcon();
     QString getInnerId();
     QString getFileName();
     QString getDesktopFile();
@@ -111,6 +113,10 @@ Q_SIGNALS:
     void desktopFileChanged(QString);
     void currentWindowChanged(uint32_t);
     void windowInfosChanged(const WindowInfoMap&);
+    void windowInfoAdded(quint32 xid, const WindowInfo &info);
+    void windowInfoRemoved(quint32 xid);
+    void windowTitleChanged(quint32 xid, const QString &title);
+    void windowAttentionChanged(quint32 xid, bool attention);
 
 private:
     // 右键菜单项
@@ -118,6 +124,8 @@ private:
     bool setPropDesktopFile(QString value);
     bool isShowOnDock() const;
     int getCurrentMode();
+    void removeExportWindowInfo(XWindow xid);
+    void requestWindowInfosChanged();
 
     AppMenuItem getMenuItemLaunch();
     AppMenuItem getMenuItemCloseAll();
@@ -134,11 +142,13 @@ private:
     bool m_isValid;
     bool m_isDocked;
     bool m_winIconPreferred;
+    bool m_windowInfosChangedPending;
     int m_mode;
 
     QString m_id;
     QString m_name;
     QString m_icon;
+    WindowIcon m_windowIcon;    // 使用窗口图标时的原始像素，此时m_icon为空
     QString m_innerId;
     QString m_desktopFile;
 
@@ -55,6 +55,7 @@ TaskManager::TaskManager(QObject *parent)
  , m_activeWindowOld(nullptr)
 {
     qRegisterMetaType<WindowInfoMap>("WindowInfoMap");
+    qRegisterMetaType<WindowInfo>("WindowInfo");
     qRegisterMetaType<uint32_t>("uint32_t");
     if (isWaylandSession()) {
         m_isWayland = true;
@@ -128,6 +128,10 @@ Q_SIGNALS:
     void frontendWindowRectChanged(const QRect &dockRect);
     void showRecentChanged(bool);
     void showMultiWindowChanged(bool);
+    void windowInfoAdded(const QString &entryId, uint xid, const QString &title, bool attention);
+    void windowInfoRemoved(const QString &entryId, uint xid);
+    void windowTitleChanged(const QString &entryId, uint xid, const QString &title);
+    void windowAttentionChanged(const QString &entryId, uint xid, bool attention);
 
 public Q_SLOTS:
     void updateHideState(bool delay);
@@ -0,0 +1,25 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "windowicon.h"
+#include "../util/imagekernels.h"
+
+#include <QHash>
+
+WindowIcon WindowIcon::fromPixels(std::vector<uint32_t> &&pixels, uint32_t width, uint32_t height)
+{
+    if (width == 0 || height == 0 || pixels.size() != size_t(width) * height)
+        return WindowIcon();
+
+    WindowIcon windowIcon;
+    windowIcon.key = qHashBits(pixels.data(), pixels.size() * sizeof(uint32_t), width);
+
+    auto *data = new std::vector<uint32_t>(std::move(pixels));
+    ImageKernels::premultiply(data->data(), data->data(), int(data->size()));
+    windowIcon.image = QImage(reinterpret_cast<uchar *>(data->data()), int(width), int(height),
+                              int(width * sizeof(uint32_t)), QImage::Format_ARGB32_Premultiplied,
+                              [](void *info) { delete static_cast<std::vector<uint32_t> *>(info); }, data);
+
+    return windowIcon;
+}
@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WINDOWICON_H
+#define WINDOWICON_H
+
+#include <QImage>
+
+#include <cstdint>
+#include <vector>
+
+// 窗口图标原始ARGB数据，拷贝时共享同一份像素
+struct WindowIcon {
+    QImage image;   // Format_ARGB32_Premultiplied
+    uint key = 0;   // 像素内容哈希，用于缓存查找与变化判断
+
+    bool isNull() const { return image.isNull(); }
+    bool operator==(const WindowIcon &rhs) const { return key == rhs.key && image.size() == rhs.image.size(); }
+    bool operator!=(const WindowIcon &rhs) const { return !(*this == rhs); }
+
+    /**
+     * @brief fromPixels 接管_NET_WM_ICON中一个图标的像素，不再额外拷贝，就地预乘后缩放与绘制时Qt无需再转换格式
+     * @param pixels 按行排列的非预乘ARGB，大小必须为width * height
+     * @return 大小不符时返回空图标
+     */
+    static WindowIcon fromPixels(std::vector<uint32_t> &&pixels, uint32_t width, uint32_t height);
+};
+
+#endif // WINDOWICON_H
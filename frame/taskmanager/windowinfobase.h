@@ -6,6 +6,7 @@
 #define WINDOWINFOBASE_H
 
 #include "processinfo.h"
+#include "windowicon.h"
 #include "xcbutils.h"
 
 #include <QString>
@@ -40,6 +41,7 @@ public:
     virtual void killClient() = 0;
     virtual QString uuid() = 0;
     virtual QString getInnerId() { return innerId; }
+    virtual WindowIcon getWindowIcon() { return WindowIcon(); }
 
     XWindow getXid() {return xid;}
     void setEntry(Entry *value) { entry = value; }
@@ -14,9 +14,11 @@
 #include <QImage>
 #include <QIcon>
 #include <QBuffer>
+#include <QGuiApplication>
 
 #include <X11/Xlib.h>
 #include <algorithm>
+#include <cmath>
 #include <qobject.h>
 #include <string>
 
@@ -31,6 +33,7 @@ WindowInfoX::WindowInfoX(XWindow _xid, QObject *parent)
  , m_hasWMTransientFor(false)
  , m_hasXEmbedInfo(false)
  , m_updateCalled(false)
+ , m_iconLoaded(false)
 {
     xid = _xid;
     m_createdTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count(); // 获取当前时间，精确到纳秒
@@ -76,12 +79,33 @@ bool WindowInfoX::shouldSkip()
 
 QString WindowInfoX::getIcon()
 {
-    if (icon.isEmpty())
-        icon = getIconFromWindow();
+    // 字符串形式只在需要对外导出（DBus、desktop文件）时才编码生成
+    if (icon.isEmpty()) {
+        const WindowIcon windowIcon = getWindowIcon();
+        if (windowIcon.isNull())
+            return icon;
+
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        windowIcon.image.save(&buffer, "PNG");
+
+        // convert to base64
+        QString encode = buffer.data().toBase64();
+        icon = QString("%1,%2").arg("data:image/png:base64").arg(encode);
+        buffer.close();
+    }
 
     return icon;
 }
 
+WindowIcon WindowInfoX::getWindowIcon()
+{
+    if (!m_iconLoaded)
+        updateIcon();
+
+    return m_windowIcon;
+}
+
 void WindowInfoX::activate()
 {
     XCB->changeActiveWindow(xid);
@@ -334,7 +358,13 @@ void WindowInfoX::updateWmName()
 
 void WindowInfoX::updateIcon()
 {
-    icon = getIconFromWindow();
+    WindowIcon windowIcon = getIconFromWindow();
+    m_iconLoaded = true;
+    if (windowIcon == m_windowIcon)
+        return;
+
+    m_windowIcon = windowIcon;
+    icon.clear();
 }
 
 void WindowInfoX::updateHasWmTransientFor()
@@ -358,27 +388,13 @@ void WindowInfoX::update()
     innerId = genInnerId(this);
 }
 
-QString WindowInfoX::getIconFromWindow()
+WindowIcon WindowInfoX::getIconFromWindow()
 {
-    WMIcon icon = XCB->getWMIcon(xid);
-
-    // invalid icon
-    if (icon.width == 0) {
-        return QString();
-    }
-
-    QImage img = QImage((uchar *)icon.data.data(), icon.width, icon.width, QImage::Format_ARGB32);
-    QBuffer buffer;
-    buffer.open(QIODevice::WriteOnly);
-    img.scaled(48, 48, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    img.save(&buffer, "PNG");
-
-    // convert to base64
-    QString encode = buffer.data().toBase64();
-    QString iconPath = QString("%1,%2").arg("data:image/png:base64").arg(encode);
-    buffer.close();
+    // 只下载与任务栏显示尺寸最接近的一个图标
+    WMIcon wmIcon = XCB->getWMIcon(xid, uint32_t(std::ceil(dockIconSize * qApp->devicePixelRatio())));
 
-    return iconPath;
+    // 图标无效时返回空图标
+    return WindowIcon::fromPixels(std::move(wmIcon.data), wmIcon.width, wmIcon.height);
 }
 
 bool WindowInfoX::isActionMinimizeAllowed()
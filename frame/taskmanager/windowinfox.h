@@ -37,6 +37,7 @@ public:
     virtual void update() override;
     virtual void killClient() override;
     virtual QString uuid() override;
+    virtual WindowIcon getWindowIcon() override;
 
     QString genInnerId(WindowInfoX *winInfo);
     QString getGtkAppId();
@@ -64,7 +65,7 @@ public:
     void updateHasWmTransientFor();
 
 private:
-    QString getIconFromWindow();
+    WindowIcon getIconFromWindow();
     bool isActionMinimizeAllowed();
     bool hasWmStateDemandsAttention();
     bool hasWmStateSkipTaskBar();
@@ -92,6 +93,8 @@ private:
     MotifWMHints m_motifWmHints;
 
     bool m_updateCalled;
+    bool m_iconLoaded;
+    WindowIcon m_windowIcon;
     ConfigureEvent *m_lastConfigureNotifyEvent;
 };
 
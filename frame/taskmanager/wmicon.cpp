@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "wmicon.h"
+
+#include <algorithm>
+
+std::vector<WMIconHeader> walkWMIconHeaders(const WMIconSizeReader &readSize)
+{
+    // https://specifications.freedesktop.org/wm-spec/wm-spec-1.3.html#idm45582154990752
+    // _NET_WM_ICON 由若干个图标依次拼接而成，每个图标以宽、高两个cardinal开头，随后是按行排列的ARGB数据
+    std::vector<WMIconHeader> headers;
+    uint32_t offset = 0;
+    uint32_t size[2];
+    uint64_t bytesAfter = 0;
+    while (readSize(offset, size, bytesAfter)) {
+        const uint64_t bytes = uint64_t(size[0]) * size[1] * sizeof(uint32_t);
+        if (bytes == 0 || bytes > bytesAfter)
+            break;
+
+        headers.push_back(WMIconHeader{offset + 2, size[0], size[1]});
+        if (bytes == bytesAfter)
+            break;
+
+        offset += 2 + size[0] * size[1];
+    }
+
+    return headers;
+}
+
+WMIconHeader pickWMIcon(const std::vector<WMIconHeader> &headers, uint32_t preferredSize)
+{
+    auto edge = [](const WMIconHeader &header) { return std::max(header.width, header.height); };
+    WMIconHeader best = headers.front();
+    for (const WMIconHeader &header : headers) {
+        const bool bestLargeEnough = preferredSize > 0 && edge(best) >= preferredSize;
+        if (preferredSize > 0 && edge(header) >= preferredSize) {
+            if (!bestLargeEnough || edge(header) < edge(best))
+                best = header;
+        } else if (!bestLargeEnough && header.width * header.height > best.width * best.height) {
+            best = header;
+        }
+    }
+
+    return best;
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WMICON_H
+#define WMICON_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// _NET_WM_ICON中的一个图标
+typedef struct {
+    uint32_t offset;    /** 像素数据在属性中的偏移，单位为32位 */
+    uint32_t width;
+    uint32_t height;
+} WMIconHeader;
+
+/**
+ * @brief 读取属性中offset（单位为32位）处图标的宽高
+ * @param offset
+ * @param size 读取到的宽、高
+ * @param bytesAfter 属性在这两个值之后剩余的字节数，与GetProperty的bytes_after相同
+ * @return 不足两个值或读取失败时返回false
+ */
+typedef std::function<bool(uint32_t offset, uint32_t size[2], uint64_t &bytesAfter)> WMIconSizeReader;
+
+/**
+ * @brief walkWMIconHeaders 依次读取_NET_WM_ICON中每个图标的宽高头部，不下载像素数据。
+ * 遇到宽高为0或像素数据不完整的图标时停止，只返回之前完整的图标
+ */
+std::vector<WMIconHeader> walkWMIconHeaders(const WMIconSizeReader &readSize);
+
+/**
+ * @brief pickWMIcon 选取不小于preferredSize的最小图标，都比它小或preferredSize为0时取最大的图标
+ * @param headers 不能为空
+ */
+WMIconHeader pickWMIcon(const std::vector<WMIconHeader> &headers, uint32_t preferredSize);
+
+#endif // WMICON_H
@@ -389,7 +389,7 @@ void X11Manager::handlePropertyNotifyEvent(XWindow xid, XCBAtom atom)
         return;
 
     if (atom == XCB->getAtom("_NET_WM_STATE")) {
-        // entry->updateExportWindowInfos();
+        entry->updateExportWindowInfo(winInfo);
     } else if (atom == XCB->getAtom("_NET_WM_ICON")) {
         if (entry->getCurrentWindowInfo() == winInfo) {
             entry->updateIcon();
@@ -398,7 +398,7 @@ void X11Manager::handlePropertyNotifyEvent(XWindow xid, XCBAtom atom)
         if (entry->getCurrentWindowInfo() == winInfo) {
             entry->updateName();
         }
-        // entry->updateExportWindowInfos();
+        entry->updateExportWindowInfo(winInfo);
     } else if (atom == XCB->getAtom("_NET_WM_ALLOWED_ACTIONS")) {
         entry->updateMenu();
     }
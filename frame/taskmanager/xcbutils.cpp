@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "xcbutils.h"
+#include "wmicon.h"
 
 #include <cstdint>
 #include <utility>
@@ -419,53 +420,46 @@ std::string XCBUtils::getWMIconName(XWindow xid)
     return ret;
 }
 
-WMIcon XCBUtils::getWMIcon(XWindow xid)
+WMIcon XCBUtils::getWMIcon(XWindow xid, uint32_t preferredSize)
 {
+    // 整个属性往往有几百KB，这里先只读取每个图标的宽高头部，再按需下载其中一个图标的像素
     WMIcon wmIcon{};
-    xcb_get_property_cookie_t cookie = xcb_ewmh_get_wm_icon(&m_ewmh, xid);
-    xcb_ewmh_get_wm_icon_reply_t reply;
-    xcb_generic_error_t* error;
+    const XCBAtom atom = getAtom("_NET_WM_ICON");
+    const std::vector<WMIconHeader> headers = walkWMIconHeaders([&](uint32_t offset, uint32_t size[2], uint64_t &bytesAfter) {
+        xcb_get_property_cookie_t cookie = xcb_get_property(m_connect, false, xid, atom, XCB_ATOM_CARDINAL, offset, 2);
+        std::shared_ptr<xcb_get_property_reply_t> reply(
+            xcb_get_property_reply(m_connect, cookie, nullptr),
+            [=](xcb_get_property_reply_t* reply){free(reply);}
+        );
+        if (!reply || reply->format != 32 || xcb_get_property_value_length(reply.get()) < 8)
+            return false;
 
-    auto ret = xcb_ewmh_get_wm_icon_reply(&m_ewmh, cookie, &reply, &error);
+        const uint32_t *value = static_cast<uint32_t *>(xcb_get_property_value(reply.get()));
+        size[0] = value[0];
+        size[1] = value[1];
+        bytesAfter = reply->bytes_after;
+        return true;
+    });
 
-    if (error) {
-        std::cout << "failed to get wm icon" << error->error_code;
-        std::free(error);
+    if (headers.empty())
         return wmIcon;
-    }
-
-    if (ret) {
-        auto fcn = [](xcb_ewmh_wm_icon_iterator_t it) {
-            // https://specifications.freedesktop.org/wm-spec/wm-spec-1.3.html#idm45582154990752
-            // The first two cardinals are width, height. Data is in rows, left to right and top to bottom
-            // Two cardinals means width and heighr, not offset.
-            const auto size = it.width * it.height;
-            std::vector<uint32_t> ret(size);
-            // data数据是按行从左至右，从上至下排列
-            uint32_t *data = it.data;
-            if (!data) {
-                return ret;
-            }
-
-            std::copy_n(data, size, ret.begin());
-            return ret;
-        };
-
-        // 获取icon中size最大的图标
-        xcb_ewmh_wm_icon_iterator_t iter = xcb_ewmh_get_wm_icon_iterator(&reply);
-        xcb_ewmh_wm_icon_iterator_t wmIconIt{0, 0, nullptr};
-        for (; iter.rem; xcb_ewmh_get_wm_icon_next(&iter)) {
-            const uint32_t size = iter.width * iter.height;
-            if (size > 0 && size > wmIconIt.width * wmIconIt.height) {
-                wmIconIt = iter;
-            }
-        }
 
-        wmIcon = WMIcon{wmIconIt.width, wmIconIt.height, fcn(wmIconIt)};
-
-        xcb_ewmh_get_wm_icon_reply_wipe(&reply); // clear
+    const WMIconHeader best = pickWMIcon(headers, preferredSize);
+    const uint32_t size = best.width * best.height;
+    xcb_get_property_cookie_t cookie = xcb_get_property(m_connect, false, xid, atom, XCB_ATOM_CARDINAL, best.offset, size);
+    std::shared_ptr<xcb_get_property_reply_t> reply(
+        xcb_get_property_reply(m_connect, cookie, nullptr),
+        [=](xcb_get_property_reply_t* reply){free(reply);}
+    );
+    if (!reply || reply->format != 32 || uint32_t(xcb_get_property_value_length(reply.get())) != size * sizeof(uint32_t)) {
+        std::cout << "failed to get wm icon of window " << xid << std::endl;
+        return wmIcon;
     }
 
+    // data数据是按行从左至右，从上至下排列
+    const uint32_t *data = static_cast<uint32_t *>(xcb_get_property_value(reply.get()));
+    wmIcon = WMIcon{best.width, best.height, std::vector<uint32_t>(data, data + size)};
+
     return wmIcon;
 }
 
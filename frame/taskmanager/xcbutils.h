@@ -201,7 +201,8 @@ public:
     std::string getWMIconName(XWindow xid);
 
     // 获取窗口图标信息 _NET_WM_ICON
-    WMIcon getWMIcon(XWindow xid);
+    // preferredSize 为 0 时取最大的图标，否则只下载不小于该尺寸的最小图标（没有则取最大的）
+    WMIcon getWMIcon(XWindow xid, uint32_t preferredSize = 0);
 
     // WM_CLIENT_LEADER
     XWindow getWMClientLeader(XWindow xid);
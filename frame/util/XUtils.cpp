@@ -8,9 +8,11 @@
 #include <QScreen>
 #include "XUtils.h"
 #include "xdo.h"
+#include "imagekernels.h"
 #include <X11/Xlib.h>
 #include <X11/Xw32defs.h>
 #include <iostream>
+#include <algorithm>
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
 #include <KWindowInfo>
@@ -198,31 +200,21 @@ QPixmap XUtils::getWindowIconNameX11(int winId) {
     XFree(data);
 
     XGetWindowProperty(m_xdo->xdpy, winId, prop, 2, width * height, False, XA_CARDINAL, &actualType, &actualFormat, &nitem, &bytes, &data);
-    unsigned int* imgData = new unsigned int[width * height];
-    unsigned long* ul = (unsigned long*) data;
-    for (int i=0; i < nitem; ++i)
-    {
-        imgData[i] = (unsigned int)ul[i];
-    }
+    if (data == NULL)
+        return QPixmap();
+
+    // Xlib以long返回32位的属性值，先收窄为ARGB再预乘
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    uint32_t *argb = reinterpret_cast<uint32_t *>(image.bits());
+    const unsigned long *ul = (unsigned long *) data;
+    const int count = std::min<int>(nitem, width * height);
+    for (int i = 0; i < count; ++i)
+        argb[i] = uint32_t(ul[i]);
     XFree(data);
 
-    QImage image(width, height, QImage::Format_ARGB32);
-    unsigned char* argb = (unsigned char*)imgData;
-    for(int y = 0; y < height; y++)
-    {
-        for(int x = 0; x < width; x++)
-        {
-            unsigned char a = argb[3];
-            unsigned char r = argb[2] * a / 255;
-            unsigned char g = argb[1] * a / 255;
-            unsigned char b = argb[0] * a / 255;
-            QRgb value = qRgba(r, g, b, a);
-            image.setPixel(x, y, value);
-            argb += 4;
-        }
-    }
+    ImageKernels::premultiply(argb, argb, count);
 
-    delete[] imgData;
     return QPixmap::fromImage(image);
 }
 
@@ -41,6 +41,8 @@ void DockSettings::init()
                     Q_EMIT windowNameShowModeChanged(m_dockSettings->value(keyShowWindowName).toInt());
                 } else if ( key == keyWindowSizeFashion) {
                     Q_EMIT windowSizeFashionChanged(m_dockSettings->value(keyWindowSizeFashion).toUInt());
+                } else if (key == keySnapshotMemoryBudget) {
+                    Q_EMIT snapshotMemoryBudgetChanged(getSnapshotMemoryBudget());
                 }
             });
     }
@@ -250,6 +252,16 @@ bool DockSettings::showMultiWindow() const
     return m_dockSettings->value(keyShowMultiWindow).toBool();
 }
 
+uint DockSettings::getSnapshotMemoryBudget() const
+{
+    // 未配置时默认64MB，足够缓存数十个窗口的预览
+    uint size = 0;
+    if (m_dockSettings)
+        size = m_dockSettings->value(keySnapshotMemoryBudget).toUInt();
+
+    return size > 0 ? size : 64;
+}
+
 int DockSettings::getWindowNameShowMode()
 {
     if (!m_dockSettings)
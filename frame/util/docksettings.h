@@ -179,6 +179,8 @@ public:
     void setShowMultiWindow(bool showMultiWindow);
     bool showMultiWindow() const;
 
+    uint getSnapshotMemoryBudget() const;
+
 Q_SIGNALS:
     // 隐藏模式改变
     void hideModeChanged(HideMode mode);
@@ -194,6 +196,8 @@ Q_SIGNALS:
     void windowNameShowModeChanged(int mode);
     // 时尚模式下，dock尺寸信息改变
     void windowSizeFashionChanged(uint size);
+    // 窗口截图内存预算改变（MB）
+    void snapshotMemoryBudgetChanged(uint size);
 
 private:
     DockSettings(QObject *paret = nullptr);
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "frameclock.h"
+
+#include <QGuiApplication>
+#include <QLoggingCategory>
+#include <QScreen>
+#include <QTimerEvent>
+
+#include <algorithm>
+
+// QT_LOGGING_RULES="dde.dock.frameclock.debug=true"时输出每次计时期间的实际帧率
+Q_LOGGING_CATEGORY(frameClockLog, "dde.dock.frameclock", QtInfoMsg)
+
+FrameClock *FrameClock::instance()
+{
+    static FrameClock *INSTANCE = new FrameClock(qApp);
+    return INSTANCE;
+}
+
+FrameClock::FrameClock(QObject *parent)
+    : QAnimationDriver(parent)
+    , m_interval(16)
+    , m_frameCount(0)
+{
+    updateInterval();
+    connect(qApp, &QGuiApplication::primaryScreenChanged, this, &FrameClock::updateInterval);
+
+    // 接管本线程所有动画的计时
+    install();
+}
+
+void FrameClock::requestFrame(QObject *context, const std::function<void()> &callback)
+{
+    // 以context合并请求，空context的请求无法合并，也无法判断是否仍然有效
+    Q_ASSERT(context);
+    if (!context)
+        return;
+
+    auto it = std::find_if(m_requests.begin(), m_requests.end(), [context](const FrameRequest &request) {
+        return request.context == context;
+    });
+
+    if (it != m_requests.end())
+        it->callback = callback;
+    else
+        m_requests.append(FrameRequest{context, callback});
+
+    startTicking();
+}
+
+void FrameClock::start()
+{
+    QAnimationDriver::start();
+
+    startTicking();
+}
+
+void FrameClock::stop()
+{
+    QAnimationDriver::stop();
+
+    if (m_requests.isEmpty())
+        stopTicking();
+}
+
+void FrameClock::timerEvent(QTimerEvent *e)
+{
+    if (e->timerId() != m_timer.timerId())
+        return QAnimationDriver::timerEvent(e);
+
+    ++m_frameCount;
+
+    // 先处理本帧的请求，回调中新提交的请求留到下一帧
+    const QVector<FrameRequest> requests = std::move(m_requests);
+    m_requests.clear();
+    for (const FrameRequest &request : requests) {
+        if (request.context)
+            request.callback();
+    }
+
+    if (isRunning())
+        advance();
+
+    // 没有动画也没有新的请求时停止计时，空闲时不再唤醒
+    if (!isRunning() && m_requests.isEmpty())
+        stopTicking();
+}
+
+void FrameClock::startTicking()
+{
+    if (m_timer.isActive())
+        return;
+
+    m_timer.start(m_interval, Qt::PreciseTimer, this);
+    m_frameCount = 0;
+    m_activeTimer.start();
+}
+
+void FrameClock::stopTicking()
+{
+    if (!m_timer.isActive())
+        return;
+
+    m_timer.stop();
+
+    const qint64 elapsed = m_activeTimer.elapsed();
+    if (elapsed > 0)
+        qCDebug(frameClockLog) << m_frameCount << "frames in" << elapsed << "ms," << m_frameCount * 1000.0 / elapsed << "fps, interval" << m_interval << "ms";
+}
+
+void FrameClock::updateInterval()
+{
+    QScreen *screen = qApp->primaryScreen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 60;
+
+    // 刷新率异常时退回60Hz
+    m_interval = refreshRate >= 30 ? qMax(4, qRound(1000 / refreshRate)) : 16;
+
+    if (m_timer.isActive())
+        m_timer.start(m_interval, Qt::PreciseTimer, this);
+}
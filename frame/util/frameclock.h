@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <QAnimationDriver>
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QVector>
+
+#include <functional>
+
+/**
+ * @brief The FrameClock class 任务栏统一的帧时钟，替换Qt默认的16ms动画驱动。
+ * 所有QAbstractAnimation以及通过requestFrame提交的更新都在同一帧中推进，只在有动画或待处理的请求时才计时，
+ * 间隔与主屏刷新率一致，同一帧内产生的重绘由Qt合并为一次
+ */
+class FrameClock : public QAnimationDriver
+{
+    Q_OBJECT
+
+public:
+    static FrameClock *instance();
+
+    /**
+     * @brief requestFrame 在下一帧执行一次callback，同一context在一帧内多次请求时只执行最后一次
+     * @param context callback所属的对象，对象销毁后不再执行，不能为空
+     * @param callback
+     */
+    void requestFrame(QObject *context, const std::function<void()> &callback);
+
+    // 帧间隔（毫秒）
+    int interval() const { return m_interval; }
+
+protected:
+    void start() override;
+    void stop() override;
+    void timerEvent(QTimerEvent *e) override;
+
+private:
+    explicit FrameClock(QObject *parent = nullptr);
+    void updateInterval();
+    void startTicking();
+    void stopTicking();
+
+private:
+    struct FrameRequest {
+        QPointer<QObject> context;
+        std::function<void()> callback;
+    };
+
+    QBasicTimer m_timer;
+    int m_interval;
+    int m_frameCount;               // 本次计时以来的帧数
+    QElapsedTimer m_activeTimer;    // 本次计时开始的时间
+    QVector<FrameRequest> m_requests;
+};
+
+#endif // FRAMECLOCK_H
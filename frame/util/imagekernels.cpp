@@ -0,0 +1,201 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "imagekernels.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define IMAGEKERNELS_NEON
+#endif
+
+namespace {
+
+const uint32_t alphaMask = 0xff000000;
+
+// 提亮系数的定点表示，c * factor / 100 近似为 ((c << 4) * multiplier) >> 16，SIMD与通用实现共用同一公式
+inline uint32_t lightenMultiplier(int factor)
+{
+    return uint32_t(factor) * 4096 / 100;
+}
+
+inline uint32_t scaleChannel(uint32_t c, uint32_t multiplier)
+{
+    return ((c << 4) * multiplier) >> 16;
+}
+
+uint32_t lightenPixel(uint32_t pixel, int factor, uint32_t multiplier)
+{
+    if ((pixel & alphaMask) != alphaMask)
+        return pixel;
+
+    const int r = (pixel >> 16) & 0xff;
+    const int g = (pixel >> 8) & 0xff;
+    const int b = pixel & 0xff;
+    const int max = std::max(std::max(r, g), b);
+    const int min = std::min(std::min(r, g), b);
+
+    // 亮度没有溢出时色相与饱和度不变，各通道等比放大
+    if (scaleChannel(uint32_t(max), multiplier) <= 0xff)
+        return alphaMask | scaleChannel(uint32_t(r), multiplier) << 16 | scaleChannel(uint32_t(g), multiplier) << 8 | scaleChannel(uint32_t(b), multiplier);
+
+    // 亮度溢出时与QColor::lighter相同，亮度取最大值，溢出的部分从饱和度中扣除
+    if (max == min)
+        return 0xffffffff;
+
+    const int64_t value = int64_t(max) * 257 * factor / 100;
+    const int64_t saturation = std::max<int64_t>(0, int64_t(max - min) * 65535 / max - (value - 65535));
+    auto channel = [=](int c) {
+        return uint32_t(255 - 255 * saturation * (max - c) / (int64_t(65535) * (max - min)));
+    };
+
+    return alphaMask | channel(r) << 16 | channel(g) << 8 | channel(b);
+}
+
+inline uint32_t premultiplyPixel(uint32_t pixel)
+{
+    const uint32_t a = pixel >> 24;
+    const uint32_t r = ((pixel >> 16) & 0xff) * a / 255;
+    const uint32_t g = ((pixel >> 8) & 0xff) * a / 255;
+    const uint32_t b = (pixel & 0xff) * a / 255;
+    return a << 24 | r << 16 | g << 8 | b;
+}
+
+#if defined(__SSE2__)
+// 每个像素的alpha复制到四个字节
+inline __m128i broadcastAlpha(__m128i pixels)
+{
+    __m128i alpha = _mm_srli_epi32(pixels, 24);
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+    return _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+}
+
+// x / 255 向下取整，x 不超过 255 * 255
+inline __m128i divideBy255(__m128i x)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+#endif
+
+#ifdef IMAGEKERNELS_NEON
+inline uint16x8_t divideBy255(uint16x8_t x)
+{
+    return vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8);
+}
+
+inline uint16x8_t scaleChannels(uint8x8_t channels, uint16_t multiplier)
+{
+    const uint16x8_t c = vshlq_n_u16(vmovl_u8(channels), 4);
+    const uint16x4_t m = vdup_n_u16(multiplier);
+    return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(c), m), 16),
+                        vshrn_n_u32(vmull_u16(vget_high_u16(c), m), 16));
+}
+#endif
+
+}
+
+void ImageKernels::lighten(uint32_t *pixels, int count, int factor)
+{
+    if (factor <= 0 || count <= 0)
+        return;
+
+    const uint32_t multiplier = lightenMultiplier(factor);
+    int i = 0;
+
+    // 四个像素都不透明且都不会溢出时走向量化的等比放大，否则逐个像素处理
+#if defined(__SSE2__)
+    if (multiplier <= 0xffff) {
+        const __m128i alpha = _mm_set1_epi32(int(alphaMask));
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i m = _mm_set1_epi16(short(multiplier));
+        const __m128i limit = _mm_set1_epi16(0xff);
+        for (; i + 4 <= count; i += 4) {
+            const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(src, alpha), alpha)) != 0xffff) {
+                for (int j = i; j < i + 4; ++j)
+                    pixels[j] = lightenPixel(pixels[j], factor, multiplier);
+                continue;
+            }
+
+            const __m128i lo = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpacklo_epi8(src, zero), 4), m);
+            const __m128i hi = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpackhi_epi8(src, zero), 4), m);
+            const __m128i overflow = _mm_or_si128(_mm_cmpgt_epi16(lo, limit), _mm_cmpgt_epi16(hi, limit));
+            // alpha通道本身也会被放大，只检查颜色通道
+            if (_mm_movemask_epi8(_mm_andnot_si128(_mm_set1_epi64x(0xffff000000000000), overflow)) != 0) {
+                for (int j = i; j < i + 4; ++j)
+                    pixels[j] = lightenPixel(pixels[j], factor, multiplier);
+                continue;
+            }
+
+            const __m128i result = _mm_or_si128(_mm_packus_epi16(lo, hi), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + i), result);
+        }
+    }
+#elif defined(IMAGEKERNELS_NEON)
+    if (multiplier <= 0xffff) {
+        const uint32x4_t alpha = vdupq_n_u32(alphaMask);
+        const uint16x8_t limit = vdupq_n_u16(0xff);
+        const uint16x8_t colorLanes = vreinterpretq_u16_u64(vdupq_n_u64(0x0000ffffffffffff));
+        for (; i + 4 <= count; i += 4) {
+            const uint32x4_t src = vld1q_u32(pixels + i);
+            const uint32x4_t opaque = vceqq_u32(vandq_u32(src, alpha), alpha);
+            if (vminvq_u32(opaque) == 0) {
+                for (int j = i; j < i + 4; ++j)
+                    pixels[j] = lightenPixel(pixels[j], factor, multiplier);
+                continue;
+            }
+
+            const uint8x16_t bytes = vreinterpretq_u8_u32(src);
+            const uint16x8_t lo = scaleChannels(vget_low_u8(bytes), uint16_t(multiplier));
+            const uint16x8_t hi = scaleChannels(vget_high_u8(bytes), uint16_t(multiplier));
+            const uint16x8_t overflow = vandq_u16(vorrq_u16(vcgtq_u16(lo, limit), vcgtq_u16(hi, limit)), colorLanes);
+            if (vmaxvq_u16(overflow) != 0) {
+                for (int j = i; j < i + 4; ++j)
+                    pixels[j] = lightenPixel(pixels[j], factor, multiplier);
+                continue;
+            }
+
+            const uint8x16_t result = vcombine_u8(vmovn_u16(lo), vmovn_u16(hi));
+            vst1q_u32(pixels + i, vorrq_u32(vreinterpretq_u32_u8(result), alpha));
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+        pixels[i] = lightenPixel(pixels[i], factor, multiplier);
+}
+
+void ImageKernels::premultiply(const uint32_t *src, uint32_t *dst, int count)
+{
+    int i = 0;
+
+#if defined(__SSE2__)
+    const __m128i alpha = _mm_set1_epi32(int(alphaMask));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i a = broadcastAlpha(pixels);
+        const __m128i lo = divideBy255(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(a, zero)));
+        const __m128i hi = divideBy255(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(a, zero)));
+        const __m128i color = _mm_andnot_si128(alpha, _mm_packus_epi16(lo, hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_or_si128(color, _mm_and_si128(pixels, alpha)));
+    }
+#elif defined(IMAGEKERNELS_NEON)
+    const uint32x4_t alpha = vdupq_n_u32(alphaMask);
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4_t pixels = vld1q_u32(src + i);
+        const uint8x16_t a = vreinterpretq_u8_u32(vmulq_n_u32(vshrq_n_u32(pixels, 24), 0x01010101));
+        const uint8x16_t c = vreinterpretq_u8_u32(pixels);
+        const uint8x8_t lo = vmovn_u16(divideBy255(vmull_u8(vget_low_u8(c), vget_low_u8(a))));
+        const uint8x8_t hi = vmovn_u16(divideBy255(vmull_u8(vget_high_u8(c), vget_high_u8(a))));
+        vst1q_u32(dst + i, vbslq_u32(alpha, pixels, vreinterpretq_u32_u8(vcombine_u8(lo, hi))));
+    }
+#endif
+
+    for (; i < count; ++i)
+        dst[i] = premultiplyPixel(src[i]);
+}
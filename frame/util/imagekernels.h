@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef IMAGEKERNELS_H
+#define IMAGEKERNELS_H
+
+#include <cstdint>
+
+/**
+ * @brief The ImageKernels class 图标处理中逐像素的热点循环，x86使用SSE2，arm64使用NEON，其余平台使用通用实现。
+ * 像素均为按32位整数存储的ARGB（与QImage::Format_ARGB32相同的内存布局）。
+ * 缩小图片没有单独实现，图标缩放使用的QImage::scaled(Qt::SmoothTransformation)在Qt内部已经向量化。
+ * 正确性测试与基准见tests/imagekernels
+ */
+class ImageKernels
+{
+public:
+    /**
+     * @brief lighten 将不透明像素按QColor::lighter(factor)的规则提亮，保持色相，半透明像素不变
+     * @param pixels
+     * @param count 像素个数
+     * @param factor 百分比，与QColor::lighter一致
+     */
+    static void lighten(uint32_t *pixels, int count, int factor);
+
+    /**
+     * @brief premultiply 非预乘ARGB转为预乘ARGB，各通道按 c * a / 255 截断，src与dst可以是同一块内存
+     * @param src
+     * @param dst
+     * @param count 像素个数
+     */
+    static void premultiply(const uint32_t *src, uint32_t *dst, int count);
+};
+
+#endif // IMAGEKERNELS_H
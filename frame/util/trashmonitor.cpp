@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "trashmonitor.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QSocketNotifier>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+static const uint32_t FilesEvents = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+static const uint32_t RootEvents = IN_CREATE | IN_MOVED_TO | IN_ONLYDIR;
+
+TrashMonitor::TrashMonitor(const QString &trashPath, QObject *parent)
+    : QObject(parent)
+    , m_trashPath(trashPath)
+    , m_filesPath(trashPath + "/files")
+    , m_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    , m_rootWatch(-1)
+    , m_filesWatch(-1)
+    , m_notifier(nullptr)
+    , m_fallbackWatcher(nullptr)
+{
+    if (m_fd == -1) {
+        qWarning() << "inotify is not available, trash will be rescanned on every change";
+        m_fallbackWatcher = new QFileSystemWatcher({m_filesPath}, this);
+        connect(m_fallbackWatcher, &QFileSystemWatcher::directoryChanged, this, &TrashMonitor::rescan);
+    } else {
+        m_rootWatch = inotify_add_watch(m_fd, QFile::encodeName(m_trashPath).constData(), RootEvents);
+        m_notifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &TrashMonitor::readEvents);
+        watchFiles();
+    }
+
+    // 先监听再遍历，两者之间发生的变化在随后处理事件时按名称合并
+    m_names = scanFiles();
+}
+
+TrashMonitor::~TrashMonitor()
+{
+    // 先注销socket notifier再关闭描述符
+    delete m_notifier;
+    m_notifier = nullptr;
+
+    if (m_fd != -1)
+        close(m_fd);
+}
+
+void TrashMonitor::rescan()
+{
+    const int oldCount = m_names.size();
+    m_names = scanFiles();
+
+    if (m_names.size() != oldCount)
+        Q_EMIT countChanged(m_names.size());
+}
+
+void TrashMonitor::readEvents()
+{
+    // 缓冲区需要按inotify_event对齐
+    alignas(struct inotify_event) char buffer[4096];
+    const int oldCount = m_names.size();
+    bool overflow = false;
+    bool filesCreated = false;
+
+    for (;;) {
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+
+        for (const char *ptr = buffer; ptr < buffer + length;) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+
+            if (event->wd == m_rootWatch) {
+                // 清空回收站时files目录会被整个删除后重建
+                if (event->len > 0 && qstrcmp(event->name, "files") == 0)
+                    filesCreated = true;
+                continue;
+            }
+
+            if (event->wd != m_filesWatch)
+                continue;
+
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                m_names.insert(QFile::decodeName(event->name));
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                m_names.remove(QFile::decodeName(event->name));
+            } else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                inotify_rm_watch(m_fd, m_filesWatch);
+                m_filesWatch = -1;
+                m_names.clear();
+            }
+        }
+    }
+
+    if (filesCreated)
+        watchFiles();
+
+    // 事件丢失后集合不再可信，事件读完之后重新遍历一次
+    if (overflow || filesCreated)
+        m_names = scanFiles();
+
+    if (m_names.size() != oldCount)
+        Q_EMIT countChanged(m_names.size());
+}
+
+void TrashMonitor::watchFiles()
+{
+    if (m_filesWatch != -1)
+        inotify_rm_watch(m_fd, m_filesWatch);
+
+    m_filesWatch = inotify_add_watch(m_fd, QFile::encodeName(m_filesPath).constData(), FilesEvents);
+}
+
+QSet<QString> TrashMonitor::scanFiles() const
+{
+    // 只读取目录项名称，不排序也不获取文件信息
+    QSet<QString> names;
+    QDirIterator it(m_filesPath, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        names.insert(it.fileName());
+    }
+
+    return names;
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TRASHMONITOR_H
+#define TRASHMONITOR_H
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class QSocketNotifier;
+class QFileSystemWatcher;
+
+/**
+ * @brief The TrashMonitor class 通过inotify跟踪回收站files目录中的项目。
+ * 启动时遍历一次，之后按新增、删除事件更新项目名的集合，只有事件队列溢出或files目录被重建时才重新遍历。
+ * 按名称增删是幂等的，遍历前已经排队的事件再次处理也不会重复计数
+ */
+class TrashMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TrashMonitor(const QString &trashPath, QObject *parent = nullptr);
+    ~TrashMonitor() override;
+
+    int count() const { return m_names.size(); }
+    bool isEmpty() const { return m_names.isEmpty(); }
+
+    // 重新统计files目录，回收站被其他方式整体修改后调用
+    void rescan();
+
+signals:
+    void countChanged(int count);
+
+private:
+    void readEvents();
+    void watchFiles();
+    QSet<QString> scanFiles() const;
+
+private:
+    const QString m_trashPath;
+    const QString m_filesPath;
+    int m_fd;
+    int m_rootWatch;        // 回收站目录，用于发现files目录被删除后重新创建
+    int m_filesWatch;
+    QSocketNotifier *m_notifier;
+    QFileSystemWatcher *m_fallbackWatcher;  // 不支持inotify时退回到每次变化都重新统计
+    QSet<QString> m_names;  // files目录中的项目名
+};
+
+#endif // TRASHMONITOR_H
@@ -20,6 +20,7 @@
  */
 
 #include "util/utils.h"
+#include "util/imagekernels.h"
 
 #include <QIcon>
 #include <QPainter>
@@ -68,29 +69,14 @@ const QPixmap Utils::lighterEffect(const QPixmap pixmap, const int delta)
     if(pixmap.width() == 0) return pixmap;
     
     QImage image = pixmap.toImage();
+    if (image.depth() != 32)
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
 
+    // 只处理不透明像素，预乘与否不影响结果
     const int width = image.width();
     const int height = image.height();
-    const int bytesPerPixel = image.bytesPerLine() / image.width();
-
     for (int i(0); i != height; ++i)
-    {
-        uchar *scanLine = image.scanLine(i);
-        for (int j(0); j != width; ++j)
-        {
-            QRgb &rgba = *(QRgb*)scanLine;
-            if (qAlpha(rgba) == 0xff) {
-                rgba = QColor::fromRgba(rgba).lighter(delta).rgba();
-//                const QColor hsv = QColor::fromRgba(rgba).toHsv();
-//                // check brightness first, color with max brightness processed with lighter will
-//                // become white like color which will ruin the whole image in general cases.
-//                if (hsv.value() < 255) {
-//                    rgba = QColor::fromRgba(rgba).lighter(delta).rgba();
-//                }
-            }
-            scanLine += bytesPerPixel;
-        }
-    }
+        ImageKernels::lighten(reinterpret_cast<uint32_t *>(image.scanLine(i)), width, delta);
 
     return QPixmap::fromImage(image);
 }
@@ -101,6 +87,16 @@ const QPixmap Utils::getIcon(const QString iconName, const int size, const qreal
     // 把size改为小于size的最大偶数 :)
     const int s = int(size * ratio) & ~1;
 
+    // 光栅化结果按(主题, 图标名, 尺寸, 缩放比)缓存，切换主题后旧的键自然不再命中。
+    // data:image/的图标名是整张图片的base64，用其MD5代替
+    const QString nameKey = iconName.startsWith("data:image/")
+            ? QString(QCryptographicHash::hash(iconName.toUtf8(), QCryptographicHash::Md5).toHex())
+            : iconName;
+    const QString cacheKey = QString("theme-icon-%1-%2-%3-%4").arg(QIcon::themeName())
+            .arg(s).arg(ratio).arg(nameKey);
+    if (QPixmapCache::find(cacheKey, &pixmap))
+        return pixmap;
+
     do {
         // load pixmap from our Cache
         if (iconName.startsWith("data:image/")) {
@@ -153,6 +149,34 @@ const QPixmap Utils::getIcon(const QString iconName, const int size, const qreal
         pixmap = pixmap.scaled(s, s, Qt::KeepAspectRatio, Qt::SmoothTransformation);
     }
     pixmap.setDevicePixelRatio(ratio);
+    QPixmapCache::insert(cacheKey, pixmap);
+    return pixmap;
+}
+
+/**
+ * @brief Utils::getIcon 由窗口图标的原始像素生成指定大小的图标，缩放结果按内容哈希缓存
+ * @param image ARGB32格式的窗口图标
+ * @param key 像素内容哈希
+ * @param size
+ * @param ratio
+ * @return
+ */
+const QPixmap Utils::getIcon(const QImage &image, const uint key, const int size, const qreal ratio)
+{
+    const int s = int(size * ratio) & ~1;
+    const QString cacheKey = QString("window-icon-%1-%2-%3").arg(key).arg(s).arg(ratio);
+
+    QPixmap pixmap;
+    if (!QPixmapCache::find(cacheKey, &pixmap)) {
+        if (image.width() != s || image.height() != s)
+            pixmap = QPixmap::fromImage(image.scaled(s, s, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+        else
+            pixmap = QPixmap::fromImage(image);
+
+        pixmap.setDevicePixelRatio(ratio);
+        QPixmapCache::insert(cacheKey, pixmap);
+    }
+
     return pixmap;
 }
 
@@ -0,0 +1,472 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "windowcapture.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QLoggingCategory>
+#include <QX11Info>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <xcb/xcb.h>
+
+#include <atomic>
+
+Q_LOGGING_CATEGORY(captureLog, "dde.dock.capture", QtInfoMsg)
+
+// dxcb插件提供的窗口共享内存的只读映射，同一块内存在窗口存在期间只映射一次
+struct ShmAttachment {
+    ShmAttachment(long shmId, uchar *data) : shmId(shmId), data(data) {}
+    ~ShmAttachment() { shmdt(data); }
+
+    long shmId;
+    uchar *data;
+};
+
+struct ShmSegment {
+    int shmId = -1;
+    char *shmAddr = nullptr;
+    ShmSeg shmSeg = 0;
+    int size = 0;
+    std::atomic<bool> inUse{false};     // 仍被返回的图片引用，释放由图片的清理函数完成，可能发生在工作线程
+};
+
+// 同时在使用的共享内存段上限，超出时退回到XGetImage
+static const int MaxShmSegments = 4;
+// mipmap最小一级的短边长度，更小的缩略图从这一级缩放
+static const int MinMipmapSize = 64;
+
+WindowCapture *WindowCapture::instance()
+{
+    // 不使用静态对象，静态对象析构时X连接已随DApplication关闭
+    static WindowCapture *INSTANCE = new WindowCapture;
+    return INSTANCE;
+}
+
+WindowCapture::WindowCapture()
+    : m_xshmAvailable(XShmQueryExtension(QX11Info::display()))
+    , m_shmInfoAtom(XInternAtom(QX11Info::display(), "_DEEPIN_DXCB_SHM_INFO", false))
+    , m_frameExtentsAtom(XInternAtom(QX11Info::display(), "_GTK_FRAME_EXTENTS", false))
+{
+    qApp->installNativeEventFilter(this);
+
+    // 共享内存段需要在X连接关闭前分离
+    QObject::connect(qApp, &QCoreApplication::aboutToQuit, [this] { releaseResources(); });
+}
+
+void WindowCapture::releaseResources()
+{
+    qApp->removeNativeEventFilter(this);
+    m_windows.clear();
+
+    // 仍被图片引用的段随进程退出释放
+    for (auto it = m_segments.begin(); it != m_segments.end();) {
+        if ((*it)->inUse) {
+            ++it;
+            continue;
+        }
+
+        releaseSegment(*it);
+        it = m_segments.erase(it);
+    }
+}
+
+QImage WindowCapture::capture(WId wid, QRect &contentRect)
+{
+    m_cost = CaptureCost();
+
+    // get window image from shm(only for deepin app)
+    QImage image = captureDSHM(wid, contentRect);
+    if (image.isNull()) {
+        // 共享内存段由X服务端直接写入，不经过socket拷贝像素
+        if (m_xshmAvailable)
+            image = captureXShm(wid);
+
+        // get window image from XGetImage(a little slow)
+        if (image.isNull())
+            image = captureXlib(wid);
+
+        if (!image.isNull())
+            contentRect = rectRemovedShadow(wid, image);
+    }
+
+    qCDebug(captureLog) << "window" << wid << (image.isNull() ? "failed," : "captured,") << m_cost.roundTrips << "X round trips,"
+                        << m_cost.shmCalls << "shm syscalls";
+    return image;
+}
+
+QImage WindowCapture::captureDSHM(WId wid, QRect &contentRect)
+{
+    WindowProperties &properties = windowProperties(wid);
+    if (!properties.shmInfoValid) {
+        properties.shmInfoValid = true;
+        properties.hasShmInfo = readShmInfo(wid, properties.shmInfo);
+
+        // 共享内存id变化说明窗口重新分配了缓冲区，旧的映射不再使用
+        if (properties.attachment && (!properties.hasShmInfo || properties.attachment->shmId != properties.shmInfo.shmid)) {
+            properties.attachment.reset();
+            // shmdt在最后一张引用旧映射的图片释放时调用
+            ++m_cost.shmCalls;
+        }
+    }
+
+    if (!properties.hasShmInfo)
+        return QImage();
+
+    const SHMInfo &info = properties.shmInfo;
+    if (!properties.attachment) {
+        uchar *image_data = static_cast<uchar *>(shmat(int(info.shmid), nullptr, SHM_RDONLY));
+        ++m_cost.shmCalls;
+        if ((qint64)image_data == -1) {
+            qDebug() << "invalid pointer of shm!";
+            return QImage();
+        }
+
+        properties.attachment = std::make_shared<ShmAttachment>(info.shmid, image_data);
+    }
+
+    // 图片持有映射的引用，窗口销毁后映射在最后一张图片释放时才解除
+    auto *attachment = new std::shared_ptr<ShmAttachment>(properties.attachment);
+    contentRect = QRect(int(info.rect.x), int(info.rect.y), int(info.rect.width), int(info.rect.height));
+    return QImage(static_cast<const uchar *>((*attachment)->data), int(info.width), int(info.height), int(info.bytesPerLine), QImage::Format(info.format),
+                  [](void *attachment) { delete static_cast<std::shared_ptr<ShmAttachment> *>(attachment); }, attachment);
+}
+
+bool WindowCapture::readShmInfo(WId wid, SHMInfo &info)
+{
+    const auto display = QX11Info::display();
+
+    Atom actual_type_return_deepin_shm;
+    int actual_format_return_deepin_shm;
+    unsigned long nitems_return_deepin_shm;
+    unsigned long bytes_after_return_deepin_shm;
+    unsigned char *prop_return_deepin_shm = nullptr;
+
+    ++m_cost.roundTrips;
+    XGetWindowProperty(display, wid, m_shmInfoAtom, 0, 32 * 9, false, AnyPropertyType,
+                       &actual_type_return_deepin_shm, &actual_format_return_deepin_shm, &nitems_return_deepin_shm,
+                       &bytes_after_return_deepin_shm, &prop_return_deepin_shm);
+
+    if (!prop_return_deepin_shm)
+        return false;
+
+    if (nitems_return_deepin_shm * sizeof(long) < sizeof(SHMInfo)) {
+        XFree(prop_return_deepin_shm);
+        return false;
+    }
+
+    info = *reinterpret_cast<SHMInfo *>(prop_return_deepin_shm);
+    XFree(prop_return_deepin_shm);
+    return true;
+}
+
+QImage WindowCapture::captureXShm(WId wid)
+{
+    const auto display = QX11Info::display();
+    XWindowAttributes attr;
+    ++m_cost.roundTrips;
+    if (!XGetWindowAttributes(display, wid, &attr) || attr.map_state != IsViewable)
+        return QImage();
+
+    XShmSegmentInfo shminfo;
+    XImage *ximage = XShmCreateImage(display, attr.visual, uint(attr.depth), ZPixmap, nullptr, &shminfo, uint(attr.width), uint(attr.height));
+    if (!ximage)
+        return QImage();
+
+    ShmSegment *segment = ximage->bits_per_pixel == 32 ? acquireSegment(ximage->bytes_per_line * ximage->height) : nullptr;
+    if (!segment) {
+        XDestroyImage(ximage);
+        return QImage();
+    }
+
+    shminfo.shmid = segment->shmId;
+    shminfo.shmaddr = ximage->data = segment->shmAddr;
+    shminfo.shmseg = segment->shmSeg;
+    shminfo.readOnly = False;
+
+    QImage image;
+    ++m_cost.roundTrips;
+    if (XShmGetImage(display, wid, ximage, 0, 0, AllPlanes)) {
+        segment->inUse = true;
+        image = QImage(reinterpret_cast<const uchar *>(segment->shmAddr), ximage->width, ximage->height, ximage->bytes_per_line, QImage::Format_RGB32,
+                       [](void *segment) { static_cast<ShmSegment *>(segment)->inUse = false; }, segment);
+    } else {
+        // 窗口部分在屏幕外，或在获取属性与截图之间被调整大小、取消映射时会返回BadMatch，
+        // 只是这一次截图失败，本次改用XGetImage，之后仍然使用共享内存
+        qDebug() << "XShmGetImage failed, fallback to XGetImage";
+    }
+
+    // 数据属于共享内存段，不能由XDestroyImage释放
+    ximage->data = nullptr;
+    XDestroyImage(ximage);
+
+    return image;
+}
+
+QImage WindowCapture::captureXlib(WId wid)
+{
+    const auto display = QX11Info::display();
+    Window unused_window;
+    int unused_int;
+    unsigned unused_uint, w, h;
+    XGetGeometry(display, wid, &unused_window, &unused_int, &unused_int, &w, &h, &unused_uint, &unused_uint);
+    m_cost.roundTrips += 2;
+    XImage *ximage = XGetImage(display, wid, 0, 0, w, h, AllPlanes, ZPixmap);
+    if (!ximage)
+        return QImage();
+
+    return QImage(reinterpret_cast<const uchar *>(ximage->data), ximage->width, ximage->height, ximage->bytes_per_line, QImage::Format_RGB32,
+                  [](void *image) { XDestroyImage(static_cast<XImage *>(image)); }, ximage);
+}
+
+QRect WindowCapture::rectRemovedShadow(WId wid, const QImage &image)
+{
+    WindowProperties &properties = windowProperties(wid);
+    if (!properties.frameExtentsValid) {
+        properties.frameExtentsValid = true;
+        properties.frameExtents = readFrameExtents(wid);
+    }
+
+    return QRect(0, 0, image.width(), image.height()).marginsRemoved(properties.frameExtents);
+}
+
+QMargins WindowCapture::readFrameExtents(WId wid)
+{
+    const auto display = QX11Info::display();
+
+    Atom actual_type_return_gtk;
+    int actual_format_return_gtk;
+    unsigned long n_items_return_gtk;
+    unsigned long bytes_after_return_gtk;
+    unsigned char *prop_to_return_gtk = nullptr;
+
+    QMargins extents;
+    ++m_cost.roundTrips;
+    const auto r = XGetWindowProperty(display, wid, m_frameExtentsAtom, 0, 4, false, XA_CARDINAL,
+                                      &actual_type_return_gtk, &actual_format_return_gtk, &n_items_return_gtk, &bytes_after_return_gtk, &prop_to_return_gtk);
+    if (!r && prop_to_return_gtk && n_items_return_gtk == 4 && actual_format_return_gtk == 32) {
+        const unsigned long *values = reinterpret_cast<const unsigned long *>(prop_to_return_gtk);
+        // _GTK_FRAME_EXTENTS的顺序为左、右、上、下
+        extents = QMargins(int(values[0]), int(values[2]), int(values[1]), int(values[3]));
+    }
+
+    if (prop_to_return_gtk)
+        XFree(prop_to_return_gtk);
+
+    return extents;
+}
+
+/**
+ * @brief WindowCapture::windowProperties 首次访问时先监听窗口的属性变化与销毁，再由调用方读取属性，避免漏掉读取期间的变化
+ * @param wid
+ * @return
+ */
+WindowCapture::WindowProperties &WindowCapture::windowProperties(WId wid)
+{
+    auto it = m_windows.find(wid);
+    if (it != m_windows.end())
+        return it.value();
+
+    // 事件掩码按连接分别记录，保留本连接已选择的其它事件
+    const auto display = QX11Info::display();
+    XWindowAttributes attr;
+    ++m_cost.roundTrips;
+    if (XGetWindowAttributes(display, wid, &attr))
+        XSelectInput(display, wid, attr.your_event_mask | PropertyChangeMask | StructureNotifyMask);
+
+    return m_windows[wid];
+}
+
+bool WindowCapture::nativeEventFilter(const QByteArray &eventType, void *message, long *result)
+{
+    Q_UNUSED(result);
+
+    if (eventType != "xcb_generic_event_t" || m_windows.isEmpty())
+        return false;
+
+    xcb_generic_event_t *event = static_cast<xcb_generic_event_t *>(message);
+    switch (event->response_type & ~0x80) {
+    case XCB_PROPERTY_NOTIFY: {
+        xcb_property_notify_event_t *notify = reinterpret_cast<xcb_property_notify_event_t *>(event);
+        auto it = m_windows.find(WId(notify->window));
+        if (it == m_windows.end())
+            break;
+
+        if (notify->atom == m_shmInfoAtom)
+            it->shmInfoValid = false;
+        else if (notify->atom == m_frameExtentsAtom)
+            it->frameExtentsValid = false;
+        break;
+    }
+    case XCB_DESTROY_NOTIFY: {
+        xcb_destroy_notify_event_t *notify = reinterpret_cast<xcb_destroy_notify_event_t *>(event);
+        m_windows.remove(WId(notify->window));
+        break;
+    }
+    default:
+        break;
+    }
+
+    return false;
+}
+
+WindowThumbnail WindowCapture::thumbnail(const QImage &image, const QRect &contentRect, const QSizeF &size, const qreal ratio)
+{
+    if (image.isNull() || contentRect.isEmpty())
+        return WindowThumbnail();
+
+    return scaleThumbnail(image, contentRect, size, ratio);
+}
+
+QVector<QImage> WindowCapture::mipmaps(const QImage &image)
+{
+    QVector<QImage> levels;
+    if (image.isNull())
+        return levels;
+
+    // 第0级顺带转换为可直接绘制的格式，并与截图引用的共享内存脱离
+    QImage level = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+    if (level.constBits() == image.constBits())
+        level = image.copy();
+
+    levels.append(level);
+    while (qMin(level.width(), level.height()) / 2 >= MinMipmapSize) {
+        level = level.scaled(level.width() / 2, level.height() / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        levels.append(level);
+    }
+
+    return levels;
+}
+
+WindowThumbnail WindowCapture::thumbnail(const QVector<QImage> &mipmaps, const QRect &contentRect, const QSizeF &size, const qreal ratio)
+{
+    if (mipmaps.isEmpty() || contentRect.isEmpty())
+        return WindowThumbnail();
+
+    // 选取有效区域不小于目标大小的最小一级，最后只需要一次比例在1/2到1之间的缩放
+    const QSizeF scaledSize = QSizeF(contentRect.size()).scaled(size * ratio, Qt::KeepAspectRatio);
+    const qreal baseWidth = mipmaps.first().width();
+    int level = 0;
+    while (level + 1 < mipmaps.size() && contentRect.width() * mipmaps.at(level + 1).width() / baseWidth >= scaledSize.width())
+        ++level;
+
+    const qreal factor = mipmaps.at(level).width() / baseWidth;
+    const QRectF levelRect(contentRect.x() * factor, contentRect.y() * factor, contentRect.width() * factor, contentRect.height() * factor);
+    return scaleThumbnail(mipmaps.at(level), levelRect, size, ratio);
+}
+
+WindowThumbnail WindowCapture::scaleThumbnail(const QImage &image, const QRectF &contentRect, const QSizeF &size, const qreal ratio)
+{
+    WindowThumbnail thumbnail;
+
+    const QSizeF scaledSize = contentRect.size().scaled(size * ratio, Qt::KeepAspectRatio);
+    const qreal scale = scaledSize.width() / contentRect.width();
+
+    thumbnail.image = image.scaled(qRound(image.width() * scale), qRound(image.height() * scale), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    thumbnail.image = thumbnail.image.convertToFormat(thumbnail.image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+    thumbnail.image.setDevicePixelRatio(ratio);
+
+    thumbnail.rect = contentRect;
+    thumbnail.rect.moveTop(contentRect.top() * scale + 0.5);
+    thumbnail.rect.moveLeft(contentRect.left() * scale + 0.5);
+    thumbnail.rect.setWidth(scaledSize.width() - 0.5);
+    thumbnail.rect.setHeight(scaledSize.height() - 0.5);
+
+    return thumbnail;
+}
+
+/**
+ * @brief WindowCapture::acquireSegment 优先复用空闲且大小合适的共享内存段，只有容量不足或远大于需要时才重新分配
+ * @param size
+ * @return 没有可用的段时返回nullptr
+ */
+ShmSegment *WindowCapture::acquireSegment(int size)
+{
+    for (ShmSegment *segment : m_segments) {
+        if (!segment->inUse && size <= segment->size && size * 4 > segment->size)
+            return segment;
+    }
+
+    for (auto it = m_segments.begin(); it != m_segments.end(); ++it) {
+        if (!(*it)->inUse) {
+            releaseSegment(*it);
+            m_segments.erase(it);
+            break;
+        }
+    }
+
+    if (m_segments.size() >= MaxShmSegments)
+        return nullptr;
+
+    ShmSegment *segment = createSegment(size);
+    if (segment)
+        m_segments.append(segment);
+
+    return segment;
+}
+
+ShmSegment *WindowCapture::createSegment(int size)
+{
+    const auto display = QX11Info::display();
+    // 无法创建或连接共享内存段时本次会话不再使用MIT-SHM
+    const int shmId = shmget(IPC_PRIVATE, size_t(size), IPC_CREAT | 0600);
+    ++m_cost.shmCalls;
+    if (shmId < 0) {
+        m_xshmAvailable = false;
+        return nullptr;
+    }
+
+    char *shmAddr = static_cast<char *>(shmat(shmId, nullptr, 0));
+    ++m_cost.shmCalls;
+    if ((qint64)shmAddr == -1) {
+        shmctl(shmId, IPC_RMID, nullptr);
+        m_xshmAvailable = false;
+        return nullptr;
+    }
+
+    XShmSegmentInfo shminfo;
+    shminfo.shmid = shmId;
+    shminfo.shmaddr = shmAddr;
+    shminfo.readOnly = False;
+    const bool attached = XShmAttach(display, &shminfo);
+    XSync(display, false);
+    // 双方都已映射，标记删除后进程退出时由内核回收
+    shmctl(shmId, IPC_RMID, nullptr);
+    ++m_cost.roundTrips;
+    ++m_cost.shmCalls;
+
+    if (!attached) {
+        shmdt(shmAddr);
+        m_xshmAvailable = false;
+        return nullptr;
+    }
+
+    ShmSegment *segment = new ShmSegment;
+    segment->shmId = shmId;
+    segment->shmAddr = shmAddr;
+    segment->shmSeg = shminfo.shmseg;
+    segment->size = size;
+    return segment;
+}
+
+void WindowCapture::releaseSegment(ShmSegment *segment)
+{
+    XShmSegmentInfo shminfo;
+    shminfo.shmseg = segment->shmSeg;
+    shminfo.shmid = segment->shmId;
+    shminfo.shmaddr = segment->shmAddr;
+    shminfo.readOnly = False;
+    XShmDetach(QX11Info::display(), &shminfo);
+    shmdt(segment->shmAddr);
+    ++m_cost.shmCalls;
+
+    delete segment;
+}
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WINDOWCAPTURE_H
+#define WINDOWCAPTURE_H
+
+#include <QImage>
+#include <QRect>
+#include <QMargins>
+#include <QWidget>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QAbstractNativeEventFilter>
+
+#include <memory>
+
+struct ShmSegment;
+struct ShmAttachment;
+
+// dxcb插件写在窗口_DEEPIN_DXCB_SHM_INFO属性中的共享内存信息
+struct SHMInfo {
+    long shmid;
+    long width;
+    long height;
+    long bytesPerLine;
+    long format;
+
+    struct Rect {
+        long x;
+        long y;
+        long width;
+        long height;
+    } rect;
+};
+
+// 缩放好的窗口缩略图，image已设置缩放比，rect为去除阴影后的有效区域（像素坐标）
+struct WindowThumbnail {
+    QImage image;
+    QRectF rect;
+};
+
+/**
+ * @brief The WindowCapture class 截取窗口内容，AppSnapshot与WindowItem共用。
+ * 依次尝试dxcb插件提供的共享内存、MIT-SHM扩展，最后退回到XGetImage。
+ * 每个窗口的共享内存映射与阴影大小在窗口存在期间保留，属性变化时才重新读取
+ */
+class WindowCapture : public QAbstractNativeEventFilter
+{
+public:
+    static WindowCapture *instance();
+
+    /**
+     * @brief capture 截取窗口当前内容，返回的图片持有自己的数据，可在任意线程使用
+     * @param wid
+     * @param contentRect 去除窗口阴影后的有效区域
+     * @return 失败时返回空图片
+     */
+    QImage capture(WId wid, QRect &contentRect);
+
+    /**
+     * @brief thumbnail 去除阴影并缩放到能放入size的大小，转换为可直接绘制的格式，不依赖X连接，可在工作线程中调用
+     * @param image capture返回的图片
+     * @param contentRect capture返回的有效区域
+     * @param size 目标区域大小（逻辑像素）
+     * @param ratio 设备缩放比
+     * @return
+     */
+    static WindowThumbnail thumbnail(const QImage &image, const QRect &contentRect, const QSizeF &size, const qreal ratio);
+
+    /**
+     * @brief mipmaps 生成截图的mipmap，第0级为转换格式后的原图，之后每级宽高减半，可在工作线程中调用
+     * @param image capture返回的图片
+     * @return
+     */
+    static QVector<QImage> mipmaps(const QImage &image);
+
+    /**
+     * @brief thumbnail 从mipmap中选取最接近的一级缩放，多次缩放到不同大小时比每次从原图缩放快得多
+     * @param mipmaps mipmaps返回的各级图片
+     * @param contentRect capture返回的有效区域（原图坐标）
+     * @param size 目标区域大小（逻辑像素）
+     * @param ratio 设备缩放比
+     * @return
+     */
+    static WindowThumbnail thumbnail(const QVector<QImage> &mipmaps, const QRect &contentRect, const QSizeF &size, const qreal ratio);
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) override;
+
+private:
+    struct WindowProperties {
+        bool shmInfoValid = false;
+        bool hasShmInfo = false;
+        SHMInfo shmInfo;
+        std::shared_ptr<ShmAttachment> attachment;
+        bool frameExtentsValid = false;
+        QMargins frameExtents;
+    };
+
+    // 一次截图中与X服务端的往返与共享内存系统调用次数，输出到dde.dock.capture日志
+    struct CaptureCost {
+        int roundTrips = 0;
+        int shmCalls = 0;
+    };
+
+    WindowCapture();
+    void releaseResources();
+
+    QImage captureDSHM(WId wid, QRect &contentRect);
+    QImage captureXShm(WId wid);
+    QImage captureXlib(WId wid);
+    bool readShmInfo(WId wid, SHMInfo &info);
+    QRect rectRemovedShadow(WId wid, const QImage &image);
+    QMargins readFrameExtents(WId wid);
+    WindowProperties &windowProperties(WId wid);
+    static WindowThumbnail scaleThumbnail(const QImage &image, const QRectF &contentRect, const QSizeF &size, const qreal ratio);
+    ShmSegment *acquireSegment(int size);
+    ShmSegment *createSegment(int size);
+    void releaseSegment(ShmSegment *segment);
+
+private:
+    bool m_xshmAvailable;
+    unsigned long m_shmInfoAtom;
+    unsigned long m_frameExtentsAtom;
+    QHash<WId, WindowProperties> m_windows;     // 窗口销毁时移除
+    QList<ShmSegment *> m_segments;     // MIT-SHM共享内存段，截图交给工作线程处理时可能同时有多张在使用
+    CaptureCost m_cost;
+};
+
+#endif // WINDOWCAPTURE_H
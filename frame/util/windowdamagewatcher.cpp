@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "windowdamagewatcher.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QX11Info>
+
+#include <xcb/xcb.h>
+#include <xcb/damage.h>
+
+#include <cstdlib>
+
+WindowDamageWatcher *WindowDamageWatcher::instance()
+{
+    static WindowDamageWatcher *INSTANCE = new WindowDamageWatcher(qApp);
+    return INSTANCE;
+}
+
+WindowDamageWatcher::WindowDamageWatcher(QObject *parent)
+    : QObject(parent)
+    , m_available(false)
+    , m_firstEvent(0)
+{
+    xcb_connection_t *connection = QX11Info::connection();
+    if (!connection)
+        return;
+
+    const xcb_query_extension_reply_t *extension = xcb_get_extension_data(connection, &xcb_damage_id);
+    if (!extension || !extension->present) {
+        qWarning() << "XDamage is not supported, window snapshots will be refreshed by timer";
+        return;
+    }
+
+    // 使用扩展前必须先协商版本
+    xcb_damage_query_version_reply_t *version = xcb_damage_query_version_reply(connection,
+        xcb_damage_query_version(connection, XCB_DAMAGE_MAJOR_VERSION, XCB_DAMAGE_MINOR_VERSION), nullptr);
+    if (!version)
+        return;
+    free(version);
+
+    m_available = true;
+    m_firstEvent = extension->first_event;
+    qApp->installNativeEventFilter(this);
+}
+
+void WindowDamageWatcher::watch(WId wid)
+{
+    auto it = m_watches.find(wid);
+    if (it != m_watches.end()) {
+        ++it->refs;
+        return;
+    }
+
+    Watch watch{0, 1, true};
+    if (m_available) {
+        xcb_connection_t *connection = QX11Info::connection();
+        watch.damage = xcb_generate_id(connection);
+        // 损坏区域由空变为非空时只通知一次，直到acknowledge清空
+        xcb_damage_create(connection, watch.damage, xcb_drawable_t(wid), XCB_DAMAGE_REPORT_LEVEL_NON_EMPTY);
+        xcb_flush(connection);
+    }
+
+    m_watches.insert(wid, watch);
+}
+
+void WindowDamageWatcher::unwatch(WId wid)
+{
+    auto it = m_watches.find(wid);
+    if (it == m_watches.end() || --it->refs > 0)
+        return;
+
+    if (m_available) {
+        // 窗口已销毁时服务端会自动释放damage，此时的BadDamage错误直接丢弃
+        xcb_connection_t *connection = QX11Info::connection();
+        xcb_discard_reply(connection, xcb_damage_destroy_checked(connection, it->damage).sequence);
+        xcb_flush(connection);
+    }
+
+    m_watches.erase(it);
+}
+
+bool WindowDamageWatcher::isDamaged(WId wid) const
+{
+    if (!m_available)
+        return true;
+
+    auto it = m_watches.find(wid);
+    return it == m_watches.end() || it->damaged;
+}
+
+void WindowDamageWatcher::acknowledge(WId wid)
+{
+    auto it = m_watches.find(wid);
+    if (it == m_watches.end() || !it->damaged)
+        return;
+
+    it->damaged = false;
+    if (m_available) {
+        xcb_connection_t *connection = QX11Info::connection();
+        xcb_damage_subtract(connection, it->damage, XCB_NONE, XCB_NONE);
+        xcb_flush(connection);
+    }
+}
+
+bool WindowDamageWatcher::nativeEventFilter(const QByteArray &eventType, void *message, long *result)
+{
+    Q_UNUSED(result);
+
+    if (eventType != "xcb_generic_event_t")
+        return false;
+
+    xcb_generic_event_t *event = static_cast<xcb_generic_event_t *>(message);
+    if ((event->response_type & ~0x80) != m_firstEvent + XCB_DAMAGE_NOTIFY)
+        return false;
+
+    xcb_damage_notify_event_t *notify = reinterpret_cast<xcb_damage_notify_event_t *>(event);
+    auto it = m_watches.find(WId(notify->drawable));
+    if (it != m_watches.end() && !it->damaged) {
+        it->damaged = true;
+        Q_EMIT damaged(WId(notify->drawable));
+    }
+
+    return true;
+}
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WINDOWDAMAGEWATCHER_H
+#define WINDOWDAMAGEWATCHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QWidget>
+#include <QAbstractNativeEventFilter>
+
+/**
+ * @brief The WindowDamageWatcher class 通过XDamage扩展监听窗口内容变化，只有窗口重绘过才需要重新截图。
+ * 每次通知后需要调用acknowledge才会收到下一次通知，因此截图频率不会超过消费者的处理频率
+ */
+class WindowDamageWatcher : public QObject, public QAbstractNativeEventFilter
+{
+    Q_OBJECT
+
+public:
+    static WindowDamageWatcher *instance();
+
+    // 服务端不支持XDamage时返回false，调用方需要自行定时刷新
+    bool isAvailable() const { return m_available; }
+
+    // 按引用计数开始/停止监听窗口
+    void watch(WId wid);
+    void unwatch(WId wid);
+
+    // 自上次acknowledge以来窗口是否重绘过，未监听的窗口或不支持XDamage时总是返回true
+    bool isDamaged(WId wid) const;
+    // 截图前调用，清空已累计的损坏区域
+    void acknowledge(WId wid);
+
+    bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) override;
+
+signals:
+    void damaged(WId wid);
+
+private:
+    explicit WindowDamageWatcher(QObject *parent = nullptr);
+
+private:
+    struct Watch {
+        uint32_t damage;
+        int refs;
+        bool damaged;
+    };
+
+    bool m_available;
+    uint8_t m_firstEvent;
+    QHash<WId, Watch> m_watches;
+};
+
+#endif // WINDOWDAMAGEWATCHER_H
@@ -0,0 +1,310 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "windowsnapshotservice.h"
+#include "windowdamagewatcher.h"
+#include "docksettings.h"
+
+#include <QCoreApplication>
+#include <QFutureInterface>
+#include <QLoggingCategory>
+#include <QTimer>
+#include <QtConcurrent>
+
+Q_LOGGING_CATEGORY(snapshotLog, "dde.dock.snapshot", QtInfoMsg)
+
+// 每个窗口保留的缩放结果个数，任务栏窗口项与预览各用一种尺寸，另留一个给尺寸切换的过程
+static const int MaxVariants = 3;
+
+namespace {
+
+QFuture<WindowThumbnail> finishedFuture(const WindowThumbnail &thumbnail)
+{
+    QFutureInterface<WindowThumbnail> interface(QFutureInterfaceBase::Started);
+    interface.reportFinished(&thumbnail);
+    return interface.future();
+}
+
+QFuture<WindowThumbnail> canceledFuture()
+{
+    QFutureInterface<WindowThumbnail> interface(QFutureInterfaceBase::Started);
+    interface.reportCanceled();
+    interface.reportFinished();
+    return interface.future();
+}
+
+}
+
+WindowSnapshotService *WindowSnapshotService::instance()
+{
+    static WindowSnapshotService *INSTANCE = new WindowSnapshotService(qApp);
+    return INSTANCE;
+}
+
+WindowSnapshotService::WindowSnapshotService(QObject *parent)
+    : QObject(parent)
+    , m_tick(0)
+    , m_generation(0)
+{
+    m_statistics.budgetBytes = qint64(DockSettings::instance()->getSnapshotMemoryBudget()) << 20;
+
+    connect(DockSettings::instance(), &DockSettings::snapshotMemoryBudgetChanged, this, [this](uint size) {
+        setMemoryBudget(qint64(size) << 20);
+    });
+
+    // 每分钟输出一次截图次数，比较空闲桌面上按XDamage刷新与定时刷新的差别
+    if (snapshotLog().isDebugEnabled()) {
+        QTimer *timer = new QTimer(this);
+        connect(timer, &QTimer::timeout, this, [this, reported = 0]() mutable {
+            QMutexLocker locker(&m_mutex);
+            qCDebug(snapshotLog) << m_statistics.captures - reported << "captures in the last minute," << m_entries.size() << "windows held,"
+                                 << "XDamage" << (WindowDamageWatcher::instance()->isAvailable() ? "available" : "unavailable");
+            reported = m_statistics.captures;
+        });
+        timer->start(60 * 1000);
+    }
+}
+
+void WindowSnapshotService::acquire(WId wid)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_entries[wid].refs++ == 0)
+        WindowDamageWatcher::instance()->watch(wid);
+}
+
+void WindowSnapshotService::release(WId wid)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(wid);
+    if (it == m_entries.end() || --it->refs > 0)
+        return;
+
+    // 不再监听的窗口无法判断截图是否过期，留着也不会再被复用
+    WindowDamageWatcher::instance()->unwatch(wid);
+    m_statistics.usedBytes -= it->bytes;
+    m_entries.erase(it);
+}
+
+QFuture<WindowThumbnail> WindowSnapshotService::thumbnail(WId wid, const QSizeF &size, const qreal ratio)
+{
+    const QSize pixelSize = (size * ratio).toSize();
+    WindowDamageWatcher *damageWatcher = WindowDamageWatcher::instance();
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(wid);
+    if (it != m_entries.end() && !it->mipmaps.isEmpty() && !damageWatcher->isDamaged(wid)) {
+        it->lastUsed = ++m_tick;
+        for (int i = 0; i < it->variants.size(); ++i) {
+            const Variant &variant = it->variants.at(i);
+            if (variant.size == pixelSize && qFuzzyCompare(variant.thumbnail.image.devicePixelRatio(), ratio)) {
+                ++m_statistics.hits;
+                it->variants.move(i, 0);
+                return finishedFuture(variant.thumbnail);
+            }
+        }
+
+        // 截图仍是最新的，只需要按新的尺寸缩放
+        ++m_statistics.misses;
+        const quint64 generation = it->generation;
+        const QVector<QImage> mipmaps = it->mipmaps;
+        const QRect contentRect = it->contentRect;
+        return QtConcurrent::run([=] { return scaleMipmaps(wid, generation, mipmaps, contentRect, size, ratio); });
+    }
+
+    // 截图之后窗口没有重绘，正在处理的这次截图仍是最新的，不必再截一次
+    if (it != m_entries.end() && !it->pending.isFinished() && !damageWatcher->isDamaged(wid)) {
+        it->lastUsed = ++m_tick;
+        if (it->pendingSize == pixelSize && qFuzzyCompare(it->pendingRatio, ratio)) {
+            ++m_statistics.hits;
+            return it->pending;
+        }
+
+        ++m_statistics.misses;
+        const quint64 generation = it->generation;
+        QFuture<WindowThumbnail> pending = it->pending;
+        return QtConcurrent::run([=]() mutable {
+            // 截图任务尚未开始时waitForFinished会在当前线程中直接执行它
+            pending.waitForFinished();
+            return scalePending(wid, generation, size, ratio);
+        });
+    }
+
+    ++m_statistics.misses;
+    ++m_statistics.captures;
+
+    // 截图前清空损坏区域，截图期间发生的重绘会再次通知
+    quint64 generation = 0;
+    if (it != m_entries.end()) {
+        damageWatcher->acknowledge(wid);
+        generation = it->generation = ++m_generation;
+        it->lastUsed = ++m_tick;
+        it->mipmaps.clear();
+        it->variants.clear();
+        m_statistics.usedBytes -= it->bytes;
+        it->bytes = 0;
+    }
+    locker.unlock();
+
+    QRect contentRect;
+    const QImage image = WindowCapture::instance()->capture(wid, contentRect);
+    if (image.isNull())
+        return canceledFuture();
+
+    const QFuture<WindowThumbnail> future = QtConcurrent::run([=] { return scaleCapture(wid, generation, image, contentRect, size, ratio); });
+
+    // 记录正在处理的截图，处理完成前的请求都复用它
+    locker.relock();
+    it = m_entries.find(wid);
+    if (generation != 0 && it != m_entries.end() && it->generation == generation) {
+        it->pending = future;
+        it->pendingSize = pixelSize;
+        it->pendingRatio = ratio;
+    }
+
+    return future;
+}
+
+void WindowSnapshotService::setMemoryBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_statistics.budgetBytes = bytes;
+    evict(0);
+}
+
+/**
+ * @brief WindowSnapshotService::isCurrent 窗口仍被持有且没有重新截图。否则结果只会被丢弃，
+ * 持有旧QFuture的控件也会忽略空的结果，保留已有的截图
+ */
+bool WindowSnapshotService::isCurrent(WId wid, quint64 generation) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(wid);
+    return it != m_entries.constEnd() && it->generation == generation;
+}
+
+/**
+ * @brief WindowSnapshotService::scaleCapture 在工作线程中处理新的截图，窗口被持有时生成mipmap并写回缓存
+ * @param generation 为0时表示窗口没有被持有，直接从截图缩放，不生成mipmap
+ */
+WindowThumbnail WindowSnapshotService::scaleCapture(WId wid, quint64 generation, const QImage &image, const QRect &contentRect, const QSizeF &size, const qreal ratio)
+{
+    if (generation == 0)
+        return WindowCapture::thumbnail(image, contentRect, size, ratio);
+
+    // 排队期间窗口已被释放或已重新截图，不必再生成mipmap
+    if (!isCurrent(wid, generation))
+        return WindowThumbnail();
+
+    const QVector<QImage> mipmaps = WindowCapture::mipmaps(image);
+    if (!isCurrent(wid, generation))
+        return WindowThumbnail();
+
+    const WindowThumbnail thumbnail = WindowCapture::thumbnail(mipmaps, contentRect, size, ratio);
+    store(wid, generation, mipmaps, contentRect, (size * ratio).toSize(), thumbnail);
+    return thumbnail;
+}
+
+WindowThumbnail WindowSnapshotService::scaleMipmaps(WId wid, quint64 generation, const QVector<QImage> &mipmaps, const QRect &contentRect, const QSizeF &size, const qreal ratio)
+{
+    if (!isCurrent(wid, generation))
+        return WindowThumbnail();
+
+    const WindowThumbnail thumbnail = WindowCapture::thumbnail(mipmaps, contentRect, size, ratio);
+    store(wid, generation, mipmaps, contentRect, (size * ratio).toSize(), thumbnail);
+    return thumbnail;
+}
+
+/**
+ * @brief WindowSnapshotService::scalePending 等待中的截图完成后，从它生成的mipmap缩放出另一种尺寸
+ */
+WindowThumbnail WindowSnapshotService::scalePending(WId wid, quint64 generation, const QSizeF &size, const qreal ratio)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(wid);
+    // 截图失败、窗口已被释放或已经重新截图时放弃
+    if (it == m_entries.end() || it->generation != generation || it->mipmaps.isEmpty())
+        return WindowThumbnail();
+
+    const QVector<QImage> mipmaps = it->mipmaps;
+    const QRect contentRect = it->contentRect;
+    locker.unlock();
+
+    return scaleMipmaps(wid, generation, mipmaps, contentRect, size, ratio);
+}
+
+/**
+ * @brief WindowSnapshotService::store 缩放结果仍属于当前代时写回缓存
+ */
+void WindowSnapshotService::store(WId wid, quint64 generation, const QVector<QImage> &mipmaps, const QRect &contentRect, const QSize &size, const WindowThumbnail &thumbnail)
+{
+    if (thumbnail.image.isNull())
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(wid);
+    if (it == m_entries.end() || it->generation != generation)
+        return;
+
+    if (it->mipmaps.isEmpty()) {
+        it->mipmaps = mipmaps;
+        it->contentRect = contentRect;
+    }
+
+    it->variants.prepend(Variant{size, thumbnail});
+    while (it->variants.size() > MaxVariants)
+        it->variants.removeLast();
+
+    m_statistics.usedBytes -= it->bytes;
+    it->bytes = 0;
+    for (const QImage &level : it->mipmaps)
+        it->bytes += level.sizeInBytes();
+    for (const Variant &variant : it->variants)
+        it->bytes += variant.thumbnail.image.sizeInBytes();
+    m_statistics.usedBytes += it->bytes;
+
+    evict(wid);
+}
+
+/**
+ * @brief WindowSnapshotService::evict 超出预算时丢弃最久未使用的窗口的截图，调用前需持有锁
+ * @param keep 刚写入的窗口，即使单独超出预算也保留
+ */
+void WindowSnapshotService::evict(WId keep)
+{
+    const int evictions = m_statistics.evictions;
+
+    while (m_statistics.usedBytes > m_statistics.budgetBytes) {
+        auto oldest = m_entries.end();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it.key() == keep || it->bytes == 0)
+                continue;
+
+            if (oldest == m_entries.end() || it->lastUsed < oldest->lastUsed)
+                oldest = it;
+        }
+
+        if (oldest == m_entries.end())
+            break;
+
+        m_statistics.usedBytes -= oldest->bytes;
+        ++m_statistics.evictions;
+        oldest->bytes = 0;
+        oldest->mipmaps.clear();
+        oldest->variants.clear();
+    }
+
+    if (m_statistics.evictions == evictions || !snapshotLog().isDebugEnabled())
+        return;
+
+    int windows = 0;
+    for (const Entry &entry : m_entries) {
+        if (!entry.mipmaps.isEmpty())
+            ++windows;
+    }
+
+    qCDebug(snapshotLog) << "evicted" << m_statistics.evictions - evictions << "windows, used"
+                         << (m_statistics.usedBytes >> 10) << "of" << (m_statistics.budgetBytes >> 10) << "KiB by"
+                         << windows << "windows, captures" << m_statistics.captures << "hits" << m_statistics.hits
+                         << "misses" << m_statistics.misses << "evictions" << m_statistics.evictions;
+}
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WINDOWSNAPSHOTSERVICE_H
+#define WINDOWSNAPSHOTSERVICE_H
+
+#include "windowcapture.h"
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QFuture>
+
+/**
+ * @brief The WindowSnapshotService class 统一管理窗口截图，任务栏窗口项与预览共用同一份截图。
+ * 每次截图生成一组mipmap，不同大小的缩略图都从最接近的一级缩放；窗口重绘后重新截图并分配新的代数，旧代的结果全部作废；
+ * 截图尚在处理时的请求共用这次截图，不会重复截图；
+ * 所有截图占用的内存受预算限制，超出时淘汰最久未使用的窗口
+ */
+class WindowSnapshotService : public QObject
+{
+    Q_OBJECT
+
+public:
+    static WindowSnapshotService *instance();
+
+    // 显示截图的控件在显示期间持有窗口，窗口未重绘时可复用截图，全部释放后截图随即丢弃
+    void acquire(WId wid);
+    void release(WId wid);
+
+    /**
+     * @brief thumbnail 获取能放入size的缩略图，已有当前代的结果时返回已完成的QFuture，
+     * 同一窗口的截图正在处理时返回（或等待）这次截图的QFuture，否则在线程池中缩放。
+     * 返回的QFuture可能被多个调用者共用，不能取消
+     * @param wid
+     * @param size 目标区域大小（逻辑像素）
+     * @param ratio 设备缩放比
+     * @return 截图失败时返回已取消的QFuture
+     */
+    QFuture<WindowThumbnail> thumbnail(WId wid, const QSizeF &size, const qreal ratio);
+
+    void setMemoryBudget(qint64 bytes);
+
+private:
+    explicit WindowSnapshotService(QObject *parent = nullptr);
+
+    bool isCurrent(WId wid, quint64 generation) const;
+    WindowThumbnail scaleCapture(WId wid, quint64 generation, const QImage &image, const QRect &contentRect, const QSizeF &size, const qreal ratio);
+    WindowThumbnail scaleMipmaps(WId wid, quint64 generation, const QVector<QImage> &mipmaps, const QRect &contentRect, const QSizeF &size, const qreal ratio);
+    WindowThumbnail scalePending(WId wid, quint64 generation, const QSizeF &size, const qreal ratio);
+    void store(WId wid, quint64 generation, const QVector<QImage> &mipmaps, const QRect &contentRect, const QSize &size, const WindowThumbnail &thumbnail);
+    void evict(WId keep);
+
+private:
+    // 淘汰截图时输出到dde.dock.snapshot日志，用于调整内存预算
+    struct Statistics {
+        qint64 usedBytes = 0;
+        qint64 budgetBytes = 0;
+        int captures = 0;       // 实际截图的次数
+        int hits = 0;           // 直接复用缩放结果的次数
+        int misses = 0;
+        int evictions = 0;
+    };
+
+    struct Variant {
+        QSize size;             // 缩略图的像素大小
+        WindowThumbnail thumbnail;
+    };
+
+    struct Entry {
+        int refs = 0;
+        quint64 generation = 0;
+        quint64 lastUsed = 0;
+        qint64 bytes = 0;
+        QVector<QImage> mipmaps;    // 截图的mipmap，与共享内存段无关
+        QRect contentRect;
+        QList<Variant> variants;    // 最近使用的在前
+        QFuture<WindowThumbnail> pending;   // 当前代的截图正在缩放、生成mipmap
+        QSize pendingSize;
+        qreal pendingRatio = 0;
+    };
+
+    mutable QMutex m_mutex;     // 缩放结果在工作线程中写回
+    QHash<WId, Entry> m_entries;
+    quint64 m_tick;
+    quint64 m_generation;       // 所有窗口共用的代数，单调递增，窗口释放后重新持有也不会与旧代重复
+    Statistics m_statistics;
+};
+
+#endif // WINDOWSNAPSHOTSERVICE_H
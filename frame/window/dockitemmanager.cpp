@@ -30,9 +30,13 @@
 DockItemManager::DockItemManager() : QObject()
     , m_taskmanager(TaskManager::instance())
     , m_qsettings(new QSettings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/setting.ini", QSettings::IniFormat))
+    , m_iconPrewarmTimer(new QTimer(this))
 {
     m_qsettings->setIniCodec(QTextCodec::codecForName("UTF-8"));
 
+    m_iconPrewarmTimer->setInterval(0);
+    connect(m_iconPrewarmTimer, &QTimer::timeout, this, &DockItemManager::prewarmNextIcon);
+
     // 应用信号
     connect(m_taskmanager, &TaskManager::entryAdded, this, [this](const Entry *entry, int index){
         appItemAdded(entry, index, true);
@@ -42,7 +46,7 @@ DockItemManager::DockItemManager() : QObject()
     // connect(DockSettings::instance(), &DockSettings::showMultiWindowChanged, this, &DockItemManager::onShowMultiWindowChanged);
 
     if (Dtk::Widget::DApplication *app = qobject_cast<Dtk::Widget::DApplication *>(qApp)) {
-        connect(app, &Dtk::Widget::DApplication::iconThemeChanged, this, &DockItemManager::refreshItemsIcon);
+        connect(app, &Dtk::Widget::DApplication::iconThemeChanged, this, &DockItemManager::onIconThemeChanged);
     }
 
     connect(qApp, &QApplication::aboutToQuit, this, &QObject::deleteLater);
@@ -70,6 +74,42 @@ void DockItemManager::refreshItemsIcon() {
     }
 }
 
+/**
+ * @brief DockItemManager::onIconThemeChanged 切换图标主题时，先逐个把新主题下的图标光栅化进缓存，
+ * 全部就绪后再一次性刷新所有应用，避免应用较多时界面卡顿或新旧主题图标混杂
+ */
+void DockItemManager::onIconThemeChanged()
+{
+    m_pendingIcons.clear();
+    for (auto item : m_itemList) {
+        // 使用窗口图标的应用不受主题影响，也不需要编码成图标名
+        if (item.isNull() || item->hasWindowIcon())
+            continue;
+
+        const QPair<QString, qreal> icon(item->iconName(), item->devicePixelRatioF());
+        if (!m_pendingIcons.contains(icon))
+            m_pendingIcons << icon;
+    }
+
+    m_iconPrewarmTimer->start();
+}
+
+/**
+ * @brief DockItemManager::prewarmNextIcon 每次事件循环只解析一个图标，保证预热期间仍能正常响应
+ */
+void DockItemManager::prewarmNextIcon()
+{
+    if (!m_pendingIcons.isEmpty()) {
+        // 尺寸与缩放比与AppItem::refreshIcon保持一致，才能命中同一份缓存
+        const QPair<QString, qreal> icon = m_pendingIcons.takeFirst();
+        Utils::getIcon(icon.first, 100 * 0.85, icon.second);
+        return;
+    }
+
+    m_iconPrewarmTimer->stop();
+    refreshItemsIcon();
+}
+
 MergeMode DockItemManager::getDockMergeMode()
 {
     int i = m_qsettings->value("mergeMode", MergeDock).toInt();
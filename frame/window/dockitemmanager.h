@@ -86,6 +86,8 @@ public slots:
 private:
     explicit DockItemManager();
     void refreshItemsIcon();
+    void onIconThemeChanged();
+    void prewarmNextIcon();
     void appItemAdded(const Entry *entry, const int index, bool updateFrame=true);
     void appItemRemoved(const QString &appId);
     void appItemRemoved(AppItem *appItem, bool animation = true);
@@ -109,6 +111,9 @@ private:
     QList<QString> m_appIDist;
     QList<QPointer<DirItem>> m_dirList;
     QList<FolderItem*> m_folderList;
+
+    QTimer *m_iconPrewarmTimer;
+    QList<QPair<QString, qreal>> m_pendingIcons;    // 切换主题后等待预先光栅化的图标名及其缩放比
 };
 
 Q_DECLARE_METATYPE(DockItemManager::ActivateAnimationType);
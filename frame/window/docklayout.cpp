@@ -0,0 +1,241 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "docklayout.h"
+
+#include <QWidget>
+
+DockArea::DockArea(DockLayout *layout)
+    : m_layout(layout)
+{
+}
+
+int DockArea::indexOf(QWidget *widget) const
+{
+    for (int i = 0; i < m_items.size(); ++i) {
+        if (m_items.at(i)->widget() == widget)
+            return i;
+    }
+
+    return -1;
+}
+
+void DockArea::insertWidget(int index, QWidget *widget)
+{
+    m_layout->addChildWidget(widget);
+
+    if (index < 0 || index > m_items.size())
+        index = m_items.size();
+
+    m_items.insert(index, new QWidgetItem(widget));
+    m_layout->invalidate();
+}
+
+void DockArea::removeWidget(QWidget *widget)
+{
+    const int index = indexOf(widget);
+    if (index == -1)
+        return;
+
+    delete m_items.takeAt(index);
+    m_layout->invalidate();
+}
+
+DockLayout::DockLayout(QWidget *parent)
+    : QLayout(parent)
+    , m_orientation(Qt::Horizontal)
+{
+}
+
+DockLayout::~DockLayout()
+{
+    QLayoutItem *item;
+    while ((item = takeAt(0)))
+        delete item;
+
+    qDeleteAll(m_areas);
+}
+
+DockArea *DockLayout::addArea()
+{
+    DockArea *area = new DockArea(this);
+    m_areas.append(area);
+    return area;
+}
+
+DockArea *DockLayout::areaOf(QWidget *widget) const
+{
+    for (DockArea *area : m_areas) {
+        if (area->indexOf(widget) != -1)
+            return area;
+    }
+
+    return nullptr;
+}
+
+void DockLayout::setOrientation(Qt::Orientation orientation)
+{
+    if (m_orientation == orientation)
+        return;
+
+    m_orientation = orientation;
+    invalidate();
+}
+
+void DockLayout::addItem(QLayoutItem *item)
+{
+    // 通过QLayout的通用接口添加的控件放在最后一个区域
+    if (m_areas.isEmpty())
+        addArea();
+
+    m_areas.last()->m_items.append(item);
+    invalidate();
+}
+
+QLayoutItem *DockLayout::itemAt(int index) const
+{
+    if (index < 0)
+        return nullptr;
+
+    for (DockArea *area : m_areas) {
+        if (index < area->m_items.size())
+            return area->m_items.at(index);
+        index -= area->m_items.size();
+    }
+
+    return nullptr;
+}
+
+QLayoutItem *DockLayout::takeAt(int index)
+{
+    if (index < 0)
+        return nullptr;
+
+    for (DockArea *area : m_areas) {
+        if (index < area->m_items.size()) {
+            QLayoutItem *item = area->m_items.takeAt(index);
+            invalidate();
+            return item;
+        }
+        index -= area->m_items.size();
+    }
+
+    return nullptr;
+}
+
+int DockLayout::count() const
+{
+    int count = 0;
+    for (DockArea *area : m_areas)
+        count += area->m_items.size();
+
+    return count;
+}
+
+QSize DockLayout::sizeHint() const
+{
+    const QMargins margins = contentsMargins();
+    return contentsSize() + QSize(margins.left() + margins.right(), margins.top() + margins.bottom());
+}
+
+QSize DockLayout::minimumSize() const
+{
+    return sizeHint();
+}
+
+Qt::Orientations DockLayout::expandingDirections() const
+{
+    // 两端留白可以任意拉伸
+    return m_orientation;
+}
+
+void DockLayout::setGeometry(const QRect &rect)
+{
+    QLayout::setGeometry(rect);
+
+    const QRect r = rect.marginsRemoved(contentsMargins());
+    const bool horizontal = m_orientation == Qt::Horizontal;
+    const int spacing = qMax(0, this->spacing());
+    const QSize contents = contentsSize();
+
+    // 所有控件之间的间距相同，整体在布局中居中，放不下时从起点开始排列
+    int pos = horizontal ? r.left() + qMax(0, (r.width() - contents.width()) / 2)
+                         : r.top() + qMax(0, (r.height() - contents.height()) / 2);
+    bool first = true;
+
+    for (DockArea *area : m_areas) {
+        int start = -1;
+        for (QLayoutItem *item : area->m_items) {
+            if (item->isEmpty())
+                continue;
+
+            if (!first)
+                pos += spacing;
+            first = false;
+
+            if (start == -1)
+                start = pos;
+
+            const QSize size = itemSize(item);
+            const QRect itemRect = horizontal ? QRect(QPoint(pos, r.top() + (r.height() - size.height()) / 2), size)
+                                              : QRect(QPoint(r.left() + (r.width() - size.width()) / 2, pos), size);
+            pos += horizontal ? size.width() : size.height();
+
+            // 插入或删除控件时只有位置变化的控件需要移动
+            if (item->geometry() != itemRect)
+                item->setGeometry(itemRect);
+        }
+
+        if (start == -1)
+            start = pos;
+
+        area->m_geometry = horizontal ? QRect(start, r.top(), pos - start, r.height())
+                                      : QRect(r.left(), start, r.width(), pos - start);
+    }
+}
+
+void DockLayout::invalidate()
+{
+    m_contentsSize = QSize();
+    QLayout::invalidate();
+}
+
+QSize DockLayout::itemSize(QLayoutItem *item) const
+{
+    // 任务栏中的控件都设置了固定大小，直接使用，不必询问sizeHint
+    const QWidget *widget = item->widget();
+    if (widget && widget->minimumSize() == widget->maximumSize())
+        return widget->minimumSize();
+
+    return item->sizeHint();
+}
+
+QSize DockLayout::contentsSize() const
+{
+    if (m_contentsSize.isValid())
+        return m_contentsSize;
+
+    const bool horizontal = m_orientation == Qt::Horizontal;
+    int length = 0;
+    int thickness = 0;
+    int visibleCount = 0;
+
+    for (DockArea *area : m_areas) {
+        for (QLayoutItem *item : area->m_items) {
+            if (item->isEmpty())
+                continue;
+
+            const QSize size = itemSize(item);
+            length += horizontal ? size.width() : size.height();
+            thickness = qMax(thickness, horizontal ? size.height() : size.width());
+            ++visibleCount;
+        }
+    }
+
+    if (visibleCount > 1)
+        length += qMax(0, spacing()) * (visibleCount - 1);
+
+    m_contentsSize = horizontal ? QSize(length, thickness) : QSize(thickness, length);
+    return m_contentsSize;
+}
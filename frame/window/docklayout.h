@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DOCKLAYOUT_H
+#define DOCKLAYOUT_H
+
+#include <QLayout>
+#include <QList>
+
+class DockLayout;
+
+/**
+ * @brief The DockArea class 任务栏中的一段区域（固定区、应用区、窗口区等），只记录自己包含哪些控件，
+ * 控件的位置统一由DockLayout计算
+ */
+class DockArea
+{
+public:
+    int count() const { return m_items.size(); }
+    bool isEmpty() const { return m_items.isEmpty(); }
+    int indexOf(QWidget *widget) const;
+    QLayoutItem *itemAt(int index) const { return m_items.value(index); }
+    // 区域在上一次布局时所占的范围，区域为空时宽度（或高度）为0
+    QRect geometry() const { return m_geometry; }
+
+    // index小于0或超出范围时添加到末尾
+    void insertWidget(int index, QWidget *widget);
+    void removeWidget(QWidget *widget);
+
+private:
+    explicit DockArea(DockLayout *layout);
+
+private:
+    friend class DockLayout;
+
+    DockLayout *m_layout;
+    QList<QLayoutItem *> m_items;
+    QRect m_geometry;
+};
+
+/**
+ * @brief The DockLayout class 任务栏专用的线性布局，所有区域的控件按顺序排成一行（或一列），整体居中。
+ * 任务栏中的控件都是固定大小，布局时按方向一次算出所有位置，不经过QBoxLayout逐层的尺寸协商，
+ * 位置没有变化的控件不会被重新设置
+ */
+class DockLayout : public QLayout
+{
+    Q_OBJECT
+
+public:
+    explicit DockLayout(QWidget *parent = nullptr);
+    ~DockLayout() override;
+
+    // 区域按添加的顺序排列，由布局持有
+    DockArea *addArea();
+    // widget所在的区域，不在布局中时返回nullptr
+    DockArea *areaOf(QWidget *widget) const;
+
+    void setOrientation(Qt::Orientation orientation);
+    Qt::Orientation orientation() const { return m_orientation; }
+
+    void addItem(QLayoutItem *item) override;
+    QLayoutItem *itemAt(int index) const override;
+    QLayoutItem *takeAt(int index) override;
+    int count() const override;
+
+    QSize sizeHint() const override;
+    QSize minimumSize() const override;
+    Qt::Orientations expandingDirections() const override;
+    void setGeometry(const QRect &rect) override;
+    void invalidate() override;
+
+private:
+    QSize itemSize(QLayoutItem *item) const;
+    QSize contentsSize() const;
+
+private:
+    friend class DockArea;
+
+    Qt::Orientation m_orientation;
+    QList<DockArea *> m_areas;
+    mutable QSize m_contentsSize;   // 所有控件排成一行所需的大小，布局失效时重新计算
+};
+
+#endif // DOCKLAYOUT_H
@@ -25,7 +25,9 @@
 #include "../item/components/appdrag.h"
 #include "../item/appitem.h"
 #include "dockitemmanager.h"
+#include "docklayout.h"
 #include "../item/diritem.h"
+#include "util/frameclock.h"
 
 #include <dtkwidget_global.h>
 #include <dtkgui_global.h>
@@ -46,7 +48,7 @@ DGUI_USE_NAMESPACE
 
 class SplitterWidget : public QWidget {
     public:
-        explicit SplitterWidget(MainPanelControl *parent) : QWidget(parent), m_parent(parent) {
+        explicit SplitterWidget(MainPanelControl *parent) : QWidget(parent), m_parent(parent), dragging(false) {
             m_type = DGuiApplicationHelper::instance()->themeType();
             connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, [this](DGuiApplicationHelper::ColorType type) {
                 m_type = type;
@@ -88,6 +90,9 @@ class SplitterWidget : public QWidget {
             releaseMouse();
             if(dragging) {
                 dragging = false;
+                // 最后一次移动可能还没等到下一帧，先按松开时的大小调整，再通知后端更新窗口大小、struts和监听区域
+                if(pendingSize != appliedSize)
+                    emit m_parent->requestResizeDockSize(pendingSize, true);
                 emit m_parent->requestResizeDockSize(m_parent->isHorizontal() ? m_parent->height() : m_parent->width(), false);
             }
         }
@@ -98,20 +103,30 @@ class SplitterWidget : public QWidget {
                 emit m_parent->requestConttextMenu();
             else if(mouseEvent->button() == Qt::LeftButton) {
                 dragging = true;
-                lastPos = QCursor::pos();
+                lastPos = mouseEvent->globalPos();
                 lastSize = m_parent->isHorizontal() ? m_parent->height() : m_parent->width();
+                pendingSize = appliedSize = lastSize;
                 grabMouse();
             }
         }
 
         void mouseMoveEvent(QMouseEvent *event) override {
             if(dragging) {
-                QPoint diffPos = QCursor::pos() - lastPos;
+                QPoint diffPos = event->globalPos() - lastPos;
                 int s = lastSize;
                 if(m_parent->m_position == Bottom) s = lastSize - diffPos.y();
                 else if(m_parent->m_position == Left) s = lastSize + diffPos.x();
                 else if(m_parent->m_position == Right) s = lastSize - diffPos.x();
-                emit m_parent->requestResizeDockSize(s, true);
+                pendingSize = s;
+
+                // 每次调整都会重设窗口大小和所有图标的大小，一帧内的多次移动只按最后的位置调整一次
+                FrameClock::instance()->requestFrame(this, [this] {
+                    if(!dragging || pendingSize == appliedSize)
+                        return;
+
+                    appliedSize = pendingSize;
+                    emit m_parent->requestResizeDockSize(appliedSize, true);
+                });
             }
         }
 
@@ -121,6 +136,8 @@ class SplitterWidget : public QWidget {
 
         QPoint lastPos;
         int lastSize;
+        int pendingSize;    // 最近一次移动要求的大小
+        int appliedSize;    // 已经提交给窗口的大小
         bool dragging;
 };
 
@@ -128,10 +145,11 @@ int beforeIndex = -1;
 static AppDrag *appDrag(nullptr);
 
 MainPanelControl::MainPanelControl(QWidget *parent) : QWidget(parent)
-    , m_fixedAreaLayout(new QBoxLayout(QBoxLayout::LeftToRight))
-    , m_appAreaLayout(new QBoxLayout(QBoxLayout::LeftToRight))
-    , m_windowAreaLayout(new QBoxLayout(QBoxLayout::LeftToRight))
-    , m_lastAreaLayout(new QBoxLayout(QBoxLayout::LeftToRight))
+    , m_mainPanelLayout(new DockLayout(this))
+    , m_fixedArea(nullptr)
+    , m_appArea(nullptr)
+    , m_windowArea(nullptr)
+    , m_lastArea(nullptr)
     , m_splitter(new SplitterWidget(this))
     , m_splitter2(new SplitterWidget(this))
     , m_position(Position::Bottom)
@@ -150,40 +168,18 @@ void MainPanelControl::init()
     setAttribute(Qt::WA_OpaquePaintEvent, false);
     setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
 
-    QBoxLayout *m_mainPanelLayout(new QBoxLayout(QBoxLayout::LeftToRight, this));
-    m_mainPanelLayout->setAlignment(Qt::AlignCenter);
-    m_mainPanelLayout->setMargin(0);
+    // 各区域的控件排成一行，相邻控件的间距都是MODE_PADDING，整体居中
+    m_mainPanelLayout->setContentsMargins(0, 0, 0, 0);
     m_mainPanelLayout->setSpacing(MODE_PADDING);
 
-    m_mainPanelLayout->addStretch(1);
-    m_mainPanelLayout->addLayout(m_fixedAreaLayout);
-    m_mainPanelLayout->addLayout(m_appAreaLayout);
-    m_mainPanelLayout->addWidget(m_splitter, 0, Qt::AlignCenter);
-    m_mainPanelLayout->addLayout(m_windowAreaLayout);
-    m_mainPanelLayout->addWidget(m_splitter2, 0, Qt::AlignCenter);
-    m_mainPanelLayout->addLayout(m_lastAreaLayout);
-    m_mainPanelLayout->addStretch(1);
-
     // 固定区域
-    m_fixedAreaLayout->setMargin(0);
-    m_fixedAreaLayout->setContentsMargins(0, 0, 0, 0);
-    m_fixedAreaLayout->setSpacing(MODE_PADDING);
-    m_fixedAreaLayout->setAlignment(Qt::AlignCenter);
+    m_fixedArea = m_mainPanelLayout->addArea();
     // 应用程序
-    m_appAreaLayout->setMargin(0);
-    m_appAreaLayout->setContentsMargins(0, 0, 0, 0);
-    m_appAreaLayout->setSpacing(MODE_PADDING);
-    m_appAreaLayout->setAlignment(Qt::AlignCenter);
-
-    m_windowAreaLayout->setMargin(0);
-    m_windowAreaLayout->setContentsMargins(0, 0, 0, 0);
-    m_windowAreaLayout->setSpacing(MODE_PADDING);
-    m_windowAreaLayout->setAlignment(Qt::AlignCenter);
-
-    m_lastAreaLayout->setMargin(0);
-    m_lastAreaLayout->setContentsMargins(0, 0, 0, 0);
-    m_lastAreaLayout->setSpacing(MODE_PADDING);
-    m_lastAreaLayout->setAlignment(Qt::AlignCenter);
+    m_appArea = m_mainPanelLayout->addArea();
+    m_mainPanelLayout->addArea()->insertWidget(0, m_splitter);
+    m_windowArea = m_mainPanelLayout->addArea();
+    m_mainPanelLayout->addArea()->insertWidget(0, m_splitter2);
+    m_lastArea = m_mainPanelLayout->addArea();
 }
 
 void MainPanelControl::updateMainPanelLayout()
@@ -191,19 +187,11 @@ void MainPanelControl::updateMainPanelLayout()
     switch (m_position) {
         case Position::Top:
         case Position::Bottom:
-            qobject_cast<QBoxLayout*>(layout())->setDirection(QBoxLayout::LeftToRight);
-            m_fixedAreaLayout->setDirection(QBoxLayout::LeftToRight);
-            m_appAreaLayout->setDirection(QBoxLayout::LeftToRight);
-            m_windowAreaLayout->setDirection(QBoxLayout::LeftToRight);
-            m_lastAreaLayout->setDirection(QBoxLayout::LeftToRight);
+            m_mainPanelLayout->setOrientation(Qt::Horizontal);
             break;
         case Position::Right:
         case Position::Left:
-            qobject_cast<QBoxLayout*>(layout())->setDirection(QBoxLayout::TopToBottom);
-            m_fixedAreaLayout->setDirection(QBoxLayout::TopToBottom);
-            m_appAreaLayout->setDirection(QBoxLayout::TopToBottom);
-            m_windowAreaLayout->setDirection(QBoxLayout::TopToBottom);
-            m_lastAreaLayout->setDirection(QBoxLayout::TopToBottom);
+            m_mainPanelLayout->setOrientation(Qt::Vertical);
             break;
     }
     resizeDockIcon();
@@ -212,30 +200,30 @@ void MainPanelControl::updateMainPanelLayout()
 void MainPanelControl::addFixedAreaItem(int index, QWidget *wdg)
 {
     wdg->setFixedSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize());
-    m_fixedAreaLayout->insertWidget(index, wdg);
+    m_fixedArea->insertWidget(index, wdg);
 }
 
 void MainPanelControl::addAppAreaItem(int index, QWidget *wdg)
 {
     // wdg->setFixedSize(DockSettings::Instance().itemSize(), DockSettings::Instance().itemSize());
-    m_appAreaLayout->insertWidget(index, wdg, 0, Qt::AlignCenter);
+    m_appArea->insertWidget(index, wdg);
 }
 
 void MainPanelControl::removeAppAreaItem(QWidget *wdg)
 {
-    m_appAreaLayout->removeWidget(wdg);
+    m_appArea->removeWidget(wdg);
 }
 
 void MainPanelControl::addWindowAreaItem(int index, QWidget *wdg)
 {
-    m_windowAreaLayout->insertWidget(index, wdg, 0, Qt::AlignCenter);
+    m_windowArea->insertWidget(index, wdg);
     m_splitter->show();
 }
 
 void MainPanelControl::addLastAreaItem(int index, QWidget *wdg)
 {
     wdg->setFixedSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize());
-    m_lastAreaLayout->insertWidget(index, wdg);
+    m_lastArea->insertWidget(index, wdg);
 }
 
 void MainPanelControl::resizeEvent(QResizeEvent *event)
@@ -267,11 +255,11 @@ void MainPanelControl::insertItem(int index, DockItem *item, bool animation)
                     removeAppAreaItem(item);
                     break;
                 case DockItem::Plugins:
-                    m_lastAreaLayout->removeWidget(item);
+                    m_lastArea->removeWidget(item);
                     break;
                 case DockItem::Window:
-                    m_windowAreaLayout->removeWidget(item);
-                    if(m_windowAreaLayout->isEmpty()) m_splitter->hide();
+                    m_windowArea->removeWidget(item);
+                    if(m_windowArea->isEmpty()) m_splitter->hide();
                     break;
                 default:
                     break;
@@ -289,7 +277,7 @@ void MainPanelControl::insertItem(int index, DockItem *item, bool animation)
         case DockItem::App:
         case DockItem::Placeholder:
         case DockItem::DirApp:
-            addAppAreaItem(index ==-1 ? m_appAreaLayout->count() : index, item);
+            addAppAreaItem(index ==-1 ? m_appArea->count() : index, item);
             break;
         case DockItem::Window:
             addWindowAreaItem(index, item);
@@ -348,12 +336,17 @@ bool MainPanelControl::eventFilter(QObject *watched, QEvent *event)
                 m_mousePressPos *= 0;
         } else if(event->type() == QEvent::MouseMove && !m_mousePressPos.isNull()) {
             QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+            // AppItem开启了鼠标跟踪，悬停时也会收到MouseMove，只有按住左键时才开始拖动
+            if (!(mouseEvent->buttons() & Qt::LeftButton))
+                return QWidget::eventFilter(watched, event);
             const QPoint distance = mouseEvent->globalPos() - m_mousePressPos;
             const int disTime = QDateTime::currentMSecsSinceEpoch() - m_mousePressTime;
             if (distance.manhattanLength() >= QApplication::startDragDistance() && disTime >= 100 /*QApplication::startDragTime()*/) {
-                beforeIndex = m_appAreaLayout->indexOf(item);
+                beforeIndex = m_appArea->indexOf(item);
                 startDrag(item);
                 beforeIndex = -1;
+                // 松开左键的事件被QDrag::exec接收，不会再经过这里
+                m_mousePressPos *= 0;
                 return true;
             }
         }
@@ -375,14 +368,14 @@ void MainPanelControl::dragEnterEvent(QDragEnterEvent *event) {
         event->ignore();
     else if (DockItemManager::instance()->appIsOnDock(DragmineData->data(m_draggingMimeKey)))
         event->ignore();
-    else event->accept(m_appAreaLayout->geometry());
+    else event->accept(m_appArea->geometry());
 
     if(event->isAccepted() == false && DragmineData->hasUrls()) {
         QList<QUrl> urls = DragmineData->urls();
         if(urls.size() == 1 && urls.first().isLocalFile()) {
             QFileInfo info(urls.first().toLocalFile());//TODO: add features
             if(info.exists() && info.isDir()) {
-                event->accept(m_lastAreaLayout->geometry() | m_splitter2->geometry());
+                event->accept(m_lastArea->geometry() | m_splitter2->geometry());
                 m_draggingMimeKey.clear();
             }
         }
@@ -394,14 +387,14 @@ void MainPanelControl::dragMoveEvent(QDragMoveEvent *event) {
         m_placeholderItem = new PlaceholderItem;
 
     if(m_draggingMimeKey.isEmpty()) {
-        if(m_lastAreaLayout->geometry().united(m_splitter2->geometry()).contains(event->pos())) {
-            if(m_lastAreaLayout->indexOf(m_placeholderItem) == -1) {
+        if(m_lastArea->geometry().united(m_splitter2->geometry()).contains(event->pos())) {
+            if(m_lastArea->indexOf(m_placeholderItem) == -1) {
                 const int width = DockItemManager::instance()->itemSize();
                 m_placeholderItem->setFixedSize(width-2, width-2);
-                m_lastAreaLayout->insertWidget(0, m_placeholderItem);
+                m_lastArea->insertWidget(0, m_placeholderItem);
             }
         } else
-            m_lastAreaLayout->removeWidget(m_placeholderItem);
+            m_lastArea->removeWidget(m_placeholderItem);
     } else
         dropTargetItem(m_placeholderItem, event->pos());
 }
@@ -410,18 +403,18 @@ void MainPanelControl::dropEvent(QDropEvent *event) {
     if (m_placeholderItem) {
         QPoint point = event->pos();
         if(m_draggingMimeKey.isEmpty()) {
-            if(m_lastAreaLayout->geometry().contains(event->pos()))
+            if(m_lastArea->geometry().contains(event->pos()))
                 emit folderAdded(event->mimeData()->urls().first().toLocalFile());
 
-            m_lastAreaLayout->removeWidget(m_placeholderItem);
+            m_lastArea->removeWidget(m_placeholderItem);
             m_placeholderItem->deleteLater();
         } else {
-            if(m_appAreaLayout->geometry().contains(point)) {
+            if(m_appArea->geometry().contains(point)) {
                 DirItem *targetItem = nullptr;
 
-                for (int i = 0; i < m_appAreaLayout->count(); ++i)
+                for (int i = 0; i < m_appArea->count(); ++i)
                 {
-                    DockItem *dockItem = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(i)->widget());
+                    DockItem *dockItem = qobject_cast<DockItem *>(m_appArea->itemAt(i)->widget());
                     if (!dockItem || dockItem == m_placeholderItem || dockItem->itemType() != DockItem::DirApp)
                         continue;
 
@@ -445,10 +438,10 @@ void MainPanelControl::dropEvent(QDropEvent *event) {
                     }
                 }
 
-                int index = m_appAreaLayout->indexOf(m_placeholderItem);
+                int index = m_appArea->indexOf(m_placeholderItem);
                 if(targetItem)
                 {
-                    index = m_appAreaLayout->indexOf(targetItem) + targetItem->currentCount();
+                    index = m_appArea->indexOf(targetItem) + targetItem->currentCount();
                     targetItem->addId(event->mimeData()->data(m_draggingMimeKey));
                 }
 
@@ -498,26 +491,26 @@ void MainPanelControl::dropTargetItem(DockItem *sourceItem, QPoint point)
     static QPoint lastPos;
     const int width = DockItemManager::instance()->itemSize();
 
-    if(m_appAreaLayout->geometry().contains(point) == false) {
-        if(m_appAreaLayout->indexOf(sourceItem) == -1) {
+    if(m_appArea->geometry().contains(point) == false) {
+        if(m_appArea->indexOf(sourceItem) == -1) {
             sourceItem->setFixedSize(width * .1, width * .1);
             if(isHorizontal())
-                addAppAreaItem(point.x() < m_appAreaLayout->geometry().x() ? 0 : m_appAreaLayout->count(), sourceItem);
+                addAppAreaItem(point.x() < m_appArea->geometry().x() ? 0 : m_appArea->count(), sourceItem);
             else
-                addAppAreaItem(point.y() < m_appAreaLayout->geometry().y() ? 0 : m_appAreaLayout->count(), sourceItem);
+                addAppAreaItem(point.y() < m_appArea->geometry().y() ? 0 : m_appArea->count(), sourceItem);
         }
         return;
     }
-    if(m_appAreaLayout->isEmpty())
+    if(m_appArea->isEmpty())
         return addAppAreaItem(0, sourceItem);
-    if(m_appAreaLayout->count() == 1 && m_appAreaLayout->itemAt(0)->widget() == sourceItem)
+    if(m_appArea->count() == 1 && m_appArea->itemAt(0)->widget() == sourceItem)
         return;
 
     const bool animation = DockItemManager::instance()->isEnableDragAnimation();
 
-    for (int i = 0; i < m_appAreaLayout->count(); ++i)
+    for (int i = 0; i < m_appArea->count(); ++i)
     {
-        DockItem *dockItem = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(i)->widget());
+        DockItem *dockItem = qobject_cast<DockItem *>(m_appArea->itemAt(i)->widget());
         qreal ratio = 1;
         QRect rect = dockItem->geometry();
 
@@ -530,14 +523,14 @@ void MainPanelControl::dropTargetItem(DockItem *sourceItem, QPoint point)
                 }
                 else if(qFabs(rect.center().x() - point.x()) < rect.width()/4)
                 {
-                    // if(animation && sourceItem->itemType() != DockItem::DirApp && m_appAreaLayout->indexOf(sourceItem) > -1)
+                    // if(animation && sourceItem->itemType() != DockItem::DirApp && m_appArea->indexOf(sourceItem) > -1)
                     // {
                     //     removeAppAreaItem(sourceItem);
                     //     sourceItem->setVisible(false);
                     // }
-                    if(m_appAreaLayout->indexOf(sourceItem) == -1)
+                    if(m_appArea->indexOf(sourceItem) == -1)
                     {
-                        addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + ( point.x() > rect.center().x() ? 1 : 0 ) , sourceItem);
+                        addAppAreaItem(m_appArea->indexOf(dockItem) + ( point.x() > rect.center().x() ? 1 : 0 ) , sourceItem);
                         sourceItem->setVisible(true);
                     }
                     if(animation) ratio = .1;
@@ -546,27 +539,27 @@ void MainPanelControl::dropTargetItem(DockItem *sourceItem, QPoint point)
                 {
                     if(qFabs(rect.center().x() - point.x()) > qFabs(rect.center().x() - lastPos.x()))
                     {
-                        if(m_appAreaLayout->indexOf(sourceItem) == -1)
+                        if(m_appArea->indexOf(sourceItem) == -1)
                         {
-                            addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + ( point.x() > rect.center().x() ? 1 : 0 ) , sourceItem);
+                            addAppAreaItem(m_appArea->indexOf(dockItem) + ( point.x() > rect.center().x() ? 1 : 0 ) , sourceItem);
                             sourceItem->setVisible(true);
                         }
                         else //if(!animation || sourceItem->itemType() == DockItem::DirApp)
                         {
                             if(point.x() > rect.center().x())
                             {
-                                if(m_appAreaLayout->indexOf(sourceItem) < m_appAreaLayout->indexOf(dockItem))
+                                if(m_appArea->indexOf(sourceItem) < m_appArea->indexOf(dockItem))
                                 {
                                     removeAppAreaItem(sourceItem);
-                                    addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + 1 , sourceItem);
+                                    addAppAreaItem(m_appArea->indexOf(dockItem) + 1 , sourceItem);
                                 }
                             }
                             else if(point.x() < rect.center().x())
                             {
-                                if(m_appAreaLayout->indexOf(sourceItem) > m_appAreaLayout->indexOf(dockItem))
+                                if(m_appArea->indexOf(sourceItem) > m_appArea->indexOf(dockItem))
                                 {
                                     removeAppAreaItem(sourceItem);
-                                    addAppAreaItem(m_appAreaLayout->indexOf(dockItem) , sourceItem);
+                                    addAppAreaItem(m_appArea->indexOf(dockItem) , sourceItem);
                                 }
                             }
                         }
@@ -589,14 +582,14 @@ void MainPanelControl::dropTargetItem(DockItem *sourceItem, QPoint point)
                 }
                 else if(qFabs(rect.center().y() - point.y()) < rect.width()/5)
                 {
-                    // if(animation && sourceItem->itemType() != DockItem::DirApp && m_appAreaLayout->indexOf(sourceItem) > -1)
+                    // if(animation && sourceItem->itemType() != DockItem::DirApp && m_appArea->indexOf(sourceItem) > -1)
                     // {
                     //     removeAppAreaItem(sourceItem);
                     //     sourceItem->setVisible(false);
                     // }
-                    if(m_appAreaLayout->indexOf(sourceItem) == -1)
+                    if(m_appArea->indexOf(sourceItem) == -1)
                     {
-                        addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + ( point.y() > rect.center().y() ? 1 : 0 ), sourceItem);
+                        addAppAreaItem(m_appArea->indexOf(dockItem) + ( point.y() > rect.center().y() ? 1 : 0 ), sourceItem);
                         sourceItem->setVisible(true);
                     }
                     if(animation) ratio = .1;
@@ -605,27 +598,27 @@ void MainPanelControl::dropTargetItem(DockItem *sourceItem, QPoint point)
                 {
                     if(qFabs(rect.center().y() - point.y()) > qFabs(rect.center().y() - lastPos.y()))
                     {
-                        if(m_appAreaLayout->indexOf(sourceItem) == -1)
+                        if(m_appArea->indexOf(sourceItem) == -1)
                         {
-                            addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + ( point.y() > rect.center().y() ? 1 : 0 ), sourceItem);
+                            addAppAreaItem(m_appArea->indexOf(dockItem) + ( point.y() > rect.center().y() ? 1 : 0 ), sourceItem);
                             sourceItem->setVisible(true);
                         }
                         else //if(!animation || sourceItem->itemType() == DockItem::DirApp)
                         {
                             if(point.y() > rect.center().y())
                             {
-                                if(m_appAreaLayout->indexOf(sourceItem) < m_appAreaLayout->indexOf(dockItem))
+                                if(m_appArea->indexOf(sourceItem) < m_appArea->indexOf(dockItem))
                                 {
                                     removeAppAreaItem(sourceItem);
-                                    addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + 1 , sourceItem);
+                                    addAppAreaItem(m_appArea->indexOf(dockItem) + 1 , sourceItem);
                                 }
                             }
                             else if(point.y() < rect.center().y())
                             {
-                                if(m_appAreaLayout->indexOf(sourceItem) > m_appAreaLayout->indexOf(dockItem))
+                                if(m_appArea->indexOf(sourceItem) > m_appArea->indexOf(dockItem))
                                 {
                                     removeAppAreaItem(sourceItem);
-                                    addAppAreaItem(m_appAreaLayout->indexOf(dockItem) , sourceItem);
+                                    addAppAreaItem(m_appArea->indexOf(dockItem) , sourceItem);
                                 }
                             }
                         }
@@ -649,11 +642,11 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
     bool needUpdateWindowSize = false;
     DockItem *targetItem = nullptr;
 
-    if(sourceItem->itemType() == DockItem::App && m_appAreaLayout->geometry().contains(point))
+    if(sourceItem->itemType() == DockItem::App && m_appArea->geometry().contains(point))
     {
-        for (int i = 0; i < m_appAreaLayout->count(); ++i)
+        for (int i = 0; i < m_appArea->count(); ++i)
         {
-            DockItem *dockItem = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(i)->widget());
+            DockItem *dockItem = qobject_cast<DockItem *>(m_appArea->itemAt(i)->widget());
             QRect rect(dockItem->pos(), dockItem->size());
             if (isHorizontal())
             {
@@ -705,7 +698,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
         {
             replaceItem = qobject_cast<AppItem*>(targetItem);
 
-            int currentIndex = m_appAreaLayout->indexOf(targetItem);
+            int currentIndex = m_appArea->indexOf(targetItem);
             if(!sourceDir)
             {
                 replaceIndex = appList.indexOf(replaceItem);
@@ -737,7 +730,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
     }
     else
     {
-        const int afterIndex = m_appAreaLayout->indexOf(sourceItem);
+        const int afterIndex = m_appArea->indexOf(sourceItem);
         sourceItem->setFixedSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize());
 
         DockItem *target = nullptr;
@@ -745,7 +738,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
         {
             AppItem *source = qobject_cast<AppItem *>(sourceItem);
             DirItem *sourceDir = source->getDirItem();
-            const int dirIndex = m_appAreaLayout->indexOf(sourceDir);
+            const int dirIndex = m_appArea->indexOf(sourceDir);
 
             sourceDir->removeItem(source);
             needUpdateWindowSize = true;
@@ -755,7 +748,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
                 int nextIndex = afterIndex + 1;
                 while(!target && dirIndex >= nextIndex)
                 {
-                    target = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(nextIndex++)->widget());
+                    target = qobject_cast<DockItem *>(m_appArea->itemAt(nextIndex++)->widget());
                     if(target->itemType() == DockItem::DirApp)
                         target = qobject_cast<DirItem *>(target)->firstItem();
                 }
@@ -765,7 +758,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
                 int prevIndex = afterIndex - 1;
                 while(!target && prevIndex >=0)
                 {
-                    target = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(prevIndex--)->widget());
+                    target = qobject_cast<DockItem *>(m_appArea->itemAt(prevIndex--)->widget());
                     if(target->itemType() == DockItem::DirApp)
                         target = qobject_cast<DirItem *>(target)->lastItem();
                 }
@@ -773,7 +766,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
         }
         else if(beforeIndex != afterIndex)
         {
-            target = qobject_cast<DockItem *>(afterIndex > beforeIndex ? m_appAreaLayout->itemAt(afterIndex - 1)->widget() : m_appAreaLayout->itemAt(afterIndex + 1)->widget());
+            target = qobject_cast<DockItem *>(afterIndex > beforeIndex ? m_appArea->itemAt(afterIndex - 1)->widget() : m_appArea->itemAt(afterIndex + 1)->widget());
             if (target->itemType() == DockItem::DirApp)
             {
                 if(afterIndex < beforeIndex)
@@ -794,9 +787,9 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
     }
 
     if(needUpdateDirApp == false)
-        for(int i=0,len=m_appAreaLayout->count(); i<len; i++)
+        for(int i=0,len=m_appArea->count(); i<len; i++)
         {
-            auto item = qobject_cast<DirItem*>(m_appAreaLayout->itemAt(i)->widget());
+            auto item = qobject_cast<DirItem*>(m_appArea->itemAt(i)->widget());
             if(item && item->isEmpty())
             {
                 needUpdateDirApp = true;
@@ -811,9 +804,9 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
 
 void MainPanelControl::resizeDockIcon()
 {
-    if(m_fixedAreaLayout->count() == 0) return;
+    if(m_fixedArea->count() == 0) return;
 
-    const int oldSize = m_fixedAreaLayout->itemAt(0)->widget()->width();
+    const int oldSize = m_fixedArea->itemAt(0)->widget()->width();
     int size;
 
     if (isHorizontal()) {
@@ -829,15 +822,15 @@ void MainPanelControl::resizeDockIcon()
     }
 
     QSize s(size, size);
-    if(m_fixedAreaLayout->count() > 0)
-        m_fixedAreaLayout->itemAt(0)->widget()->setFixedSize(s);
+    if(m_fixedArea->count() > 0)
+        m_fixedArea->itemAt(0)->widget()->setFixedSize(s);
 
-    for (int i = 0; i < m_appAreaLayout->count(); ++ i)
-        m_appAreaLayout->itemAt(i)->widget()->setFixedSize(s);
+    for (int i = 0; i < m_appArea->count(); ++ i)
+        m_appArea->itemAt(i)->widget()->setFixedSize(s);
 
-    for(int i(0); i < m_windowAreaLayout->count(); ++i)
-        m_windowAreaLayout->itemAt(i)->widget()->setFixedSize(s);
+    for(int i(0); i < m_windowArea->count(); ++i)
+        m_windowArea->itemAt(i)->widget()->setFixedSize(s);
 
-    for(int i(0); i < m_lastAreaLayout->count(); ++i)
-        m_lastAreaLayout->itemAt(i)->widget()->setFixedSize(s);
+    for(int i(0); i < m_lastArea->count(); ++i)
+        m_lastArea->itemAt(i)->widget()->setFixedSize(s);
 }
\ No newline at end of file
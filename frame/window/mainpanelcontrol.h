@@ -25,7 +25,7 @@
 #include "../interfaces/constants.h"
 
 #include <QWidget>
-#include <QBoxLayout>
+#include <QPointer>
 
 using namespace Dock;
 
@@ -33,6 +33,8 @@ class DockItem;
 class AppItem;
 class PlaceholderItem;
 class SplitterWidget;
+class DockLayout;
+class DockArea;
 class MainPanelControl : public QWidget
 {
     Q_OBJECT
@@ -81,10 +83,11 @@ signals:
     void requestResizeDockSize(int offset, bool dragging);
 
 private:
-    QBoxLayout *m_fixedAreaLayout;
-    QBoxLayout *m_appAreaLayout;
-    QBoxLayout *m_windowAreaLayout;
-    QBoxLayout *m_lastAreaLayout;
+    DockLayout *m_mainPanelLayout;
+    DockArea *m_fixedArea;
+    DockArea *m_appArea;
+    DockArea *m_windowArea;
+    DockArea *m_lastArea;
 
     SplitterWidget *m_splitter;
     SplitterWidget *m_splitter2;
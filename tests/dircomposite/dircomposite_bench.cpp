@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "item/components/dircomposite.h"
+
+#include <QPainter>
+#include <QtTest>
+
+static const QSize DirSize(48, 48);
+static const int MemberWidth = 48;
+
+namespace {
+
+QIcon solidIcon(const QColor &color)
+{
+    QPixmap pixmap(64, 64);
+    pixmap.fill(color);
+    return QIcon(pixmap);
+}
+
+QList<DirComposite::Member> sampleMembers()
+{
+    QList<DirComposite::Member> members;
+    for (const QColor &color : {QColor(Qt::red), QColor(Qt::green), QColor(Qt::blue), QColor(Qt::yellow), QColor(Qt::black)})
+        members.append(DirComposite::Member{solidIcon(color), MemberWidth});
+
+    return members;
+}
+
+}
+
+class DirCompositeBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void reuse();
+    void memberIconChanged();
+    void onlyFirstFourMembers();
+    void sizeChanged();
+    void benchmarkCached();
+    void benchmarkRebuild();
+};
+
+/**
+ * @brief DirCompositeBench::reuse 内容不变时返回同一张合成图
+ */
+void DirCompositeBench::reuse()
+{
+    DirComposite composite;
+    const QList<DirComposite::Member> members = sampleMembers();
+
+    const QPixmap first = composite.pixmap(DirSize, 1, members);
+    QVERIFY(!first.isNull());
+    QCOMPARE(first.size(), DirSize);
+    QCOMPARE(composite.pixmap(DirSize, 1, members).cacheKey(), first.cacheKey());
+}
+
+/**
+ * @brief DirCompositeBench::memberIconChanged 成员更换图标后重新生成，新图中是新的图标
+ */
+void DirCompositeBench::memberIconChanged()
+{
+    DirComposite composite;
+    QList<DirComposite::Member> members = sampleMembers();
+    const QPixmap before = composite.pixmap(DirSize, 1, members);
+
+    members[0].icon = solidIcon(Qt::magenta);
+    const QPixmap after = composite.pixmap(DirSize, 1, members);
+    QVERIFY(after.cacheKey() != before.cacheKey());
+
+    // 第一个成员位于左上角
+    QCOMPARE(after.toImage().pixelColor(12, 12), QColor(Qt::magenta));
+    QCOMPARE(before.toImage().pixelColor(12, 12), QColor(Qt::red));
+}
+
+/**
+ * @brief DirCompositeBench::onlyFirstFourMembers 只显示前四个成员，之后的成员变化不影响合成图
+ */
+void DirCompositeBench::onlyFirstFourMembers()
+{
+    DirComposite composite;
+    QList<DirComposite::Member> members = sampleMembers();
+    const QPixmap before = composite.pixmap(DirSize, 1, members);
+
+    members[4].icon = solidIcon(Qt::magenta);
+    QCOMPARE(composite.pixmap(DirSize, 1, members).cacheKey(), before.cacheKey());
+}
+
+/**
+ * @brief DirCompositeBench::sizeChanged 大小或缩放比变化后重新生成
+ */
+void DirCompositeBench::sizeChanged()
+{
+    DirComposite composite;
+    const QList<DirComposite::Member> members = sampleMembers();
+    const QPixmap before = composite.pixmap(DirSize, 1, members);
+
+    const QPixmap larger = composite.pixmap(DirSize * 2, 1, members);
+    QCOMPARE(larger.size(), DirSize * 2);
+
+    const QPixmap scaled = composite.pixmap(DirSize * 2, 2, members);
+    QCOMPARE(scaled.size(), DirSize * 4);
+    QCOMPARE(scaled.devicePixelRatio(), qreal(2));
+    QVERIFY(scaled.cacheKey() != larger.cacheKey() && larger.cacheKey() != before.cacheKey());
+}
+
+/**
+ * @brief DirCompositeBench::benchmarkCached 悬停重绘时的情况：计算标识后直接绘制上次的结果
+ */
+void DirCompositeBench::benchmarkCached()
+{
+    DirComposite composite;
+    const QList<DirComposite::Member> members = sampleMembers();
+    QImage target(DirSize, QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        QPainter painter(&target);
+        painter.drawPixmap(0, 0, composite.pixmap(DirSize, 1, members));
+    }
+}
+
+/**
+ * @brief DirCompositeBench::benchmarkRebuild 每次绘制都改变标识，相当于原先每帧重新合成
+ */
+void DirCompositeBench::benchmarkRebuild()
+{
+    DirComposite composite;
+    QList<DirComposite::Member> members = sampleMembers();
+    QImage target(DirSize, QImage::Format_ARGB32_Premultiplied);
+    int width = MemberWidth;
+
+    QBENCHMARK {
+        members[0].width = ++width % 2 ? MemberWidth : MemberWidth + 1;
+        QPainter painter(&target);
+        painter.drawPixmap(0, 0, composite.pixmap(DirSize, 1, members));
+    }
+}
+
+QTEST_MAIN(DirCompositeBench)
+
+#include "dircomposite_bench.moc"
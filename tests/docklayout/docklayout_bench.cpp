@@ -0,0 +1,239 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "window/docklayout.h"
+
+#include <QBoxLayout>
+#include <QScopedPointer>
+#include <QWidget>
+#include <QtTest>
+
+// 与MainPanelControl一致：固定区、应用区、窗口区
+static const int AreaCount = 3;
+static const int ItemCount = 100;
+static const int ItemSize = 40;
+static const int Spacing = 10;
+
+/**
+ * @brief The Strip class 同一组操作分别交给DockLayout和原先嵌套的QBoxLayout完成，便于对比
+ */
+class Strip
+{
+public:
+    explicit Strip(bool boxLayout)
+        : m_container(new QWidget)
+        , m_dockLayout(nullptr)
+        , m_boxLayout(nullptr)
+    {
+        if (boxLayout) {
+            m_boxLayout = new QBoxLayout(QBoxLayout::LeftToRight, m_container.data());
+            m_boxLayout->setSpacing(Spacing);
+            m_boxLayout->setContentsMargins(0, 0, 0, 0);
+            m_boxLayout->addStretch();
+            for (int i = 0; i < AreaCount; ++i) {
+                QBoxLayout *area = new QBoxLayout(QBoxLayout::LeftToRight);
+                area->setSpacing(Spacing);
+                area->setContentsMargins(0, 0, 0, 0);
+                m_boxLayout->addLayout(area);
+                m_boxAreas.append(area);
+            }
+            m_boxLayout->addStretch();
+        } else {
+            m_dockLayout = new DockLayout(m_container.data());
+            m_dockLayout->setSpacing(Spacing);
+            m_dockLayout->setContentsMargins(0, 0, 0, 0);
+            for (int i = 0; i < AreaCount; ++i)
+                m_dockAreas.append(m_dockLayout->addArea());
+        }
+
+        m_container->resize(ItemCount * (ItemSize + Spacing) + 200, ItemSize + 20);
+        m_container->show();
+    }
+
+    QWidget *createItem()
+    {
+        QWidget *item = new QWidget(m_container.data());
+        item->setFixedSize(ItemSize, ItemSize);
+        item->show();
+        return item;
+    }
+
+    void insert(int area, int index, QWidget *item)
+    {
+        if (m_dockLayout)
+            m_dockAreas.at(area)->insertWidget(index, item);
+        else
+            m_boxAreas.at(area)->insertWidget(index, item);
+    }
+
+    void remove(int area, QWidget *item)
+    {
+        if (m_dockLayout)
+            m_dockAreas.at(area)->removeWidget(item);
+        else
+            m_boxAreas.at(area)->removeWidget(item);
+    }
+
+    // 不经过事件循环，直接完成一次布局
+    void layout(const QRect &rect)
+    {
+        if (m_dockLayout) {
+            m_dockLayout->setGeometry(rect);
+        } else {
+            m_boxLayout->activate();
+            m_boxLayout->setGeometry(rect);
+        }
+    }
+
+    QRect rect() const { return m_container->rect(); }
+
+private:
+    QScopedPointer<QWidget> m_container;
+    DockLayout *m_dockLayout;
+    QBoxLayout *m_boxLayout;
+    QList<DockArea *> m_dockAreas;
+    QList<QBoxLayout *> m_boxAreas;
+};
+
+class DockLayoutBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void positions();
+    void removeKeepsOthers();
+    void overflow();
+    void benchmarkInsertRemove_data();
+    void benchmarkInsertRemove();
+    void benchmarkResize_data();
+    void benchmarkResize();
+
+private:
+    // 每个区域平均分配，返回按顺序排列的所有控件
+    static QList<QWidget *> fill(Strip &strip, int count);
+};
+
+QList<QWidget *> DockLayoutBench::fill(Strip &strip, int count)
+{
+    QList<QWidget *> items;
+    for (int i = 0; i < count; ++i) {
+        QWidget *item = strip.createItem();
+        strip.insert(i * AreaCount / count, -1, item);
+        items.append(item);
+    }
+
+    return items;
+}
+
+/**
+ * @brief DockLayoutBench::positions 所有区域的控件排成一行，间距相同，整体居中
+ */
+void DockLayoutBench::positions()
+{
+    Strip strip(false);
+    const QList<QWidget *> items = fill(strip, ItemCount);
+    const QRect rect = strip.rect();
+    strip.layout(rect);
+
+    const int length = ItemCount * ItemSize + (ItemCount - 1) * Spacing;
+    int x = (rect.width() - length) / 2;
+    for (QWidget *item : items) {
+        QCOMPARE(item->geometry(), QRect(x, (rect.height() - ItemSize) / 2, ItemSize, ItemSize));
+        x += ItemSize + Spacing;
+    }
+}
+
+/**
+ * @brief DockLayoutBench::removeKeepsOthers 删除控件后其余控件依次前移，与重新布局的结果一致
+ */
+void DockLayoutBench::removeKeepsOthers()
+{
+    Strip strip(false);
+    QList<QWidget *> items = fill(strip, ItemCount);
+    const QRect rect = strip.rect();
+    strip.layout(rect);
+
+    const QRect first = items.first()->geometry();
+    QWidget *removed = items.takeAt(ItemCount / 2);
+    strip.remove(1, removed);
+    delete removed;
+    strip.layout(rect);
+
+    // 整体仍然居中，少了一个控件，起点右移半个控件加间距
+    QCOMPARE(items.first()->x(), first.x() + (ItemSize + Spacing) / 2);
+    for (int i = 1; i < items.size(); ++i)
+        QCOMPARE(items.at(i)->x(), items.at(i - 1)->x() + ItemSize + Spacing);
+}
+
+/**
+ * @brief DockLayoutBench::overflow 放不下时从起点开始排列
+ */
+void DockLayoutBench::overflow()
+{
+    Strip strip(false);
+    const QList<QWidget *> items = fill(strip, ItemCount);
+    strip.layout(QRect(0, 0, ItemSize * 10, ItemSize));
+
+    QCOMPARE(items.first()->x(), 0);
+    QCOMPARE(items.last()->x(), (ItemCount - 1) * (ItemSize + Spacing));
+}
+
+void DockLayoutBench::benchmarkInsertRemove_data()
+{
+    QTest::addColumn<bool>("boxLayout");
+
+    QTest::newRow("DockLayout") << false;
+    QTest::newRow("QBoxLayout") << true;
+}
+
+/**
+ * @brief DockLayoutBench::benchmarkInsertRemove 100个控件时在应用区中间插入再删除一个控件，每次变化后重新布局
+ */
+void DockLayoutBench::benchmarkInsertRemove()
+{
+    QFETCH(bool, boxLayout);
+
+    Strip strip(boxLayout);
+    fill(strip, ItemCount);
+    const QRect rect = strip.rect();
+    strip.layout(rect);
+
+    QWidget *item = strip.createItem();
+    QBENCHMARK {
+        strip.insert(1, ItemCount / AreaCount / 2, item);
+        strip.layout(rect);
+        strip.remove(1, item);
+        strip.layout(rect);
+    }
+}
+
+void DockLayoutBench::benchmarkResize_data()
+{
+    QTest::addColumn<bool>("boxLayout");
+
+    QTest::newRow("DockLayout") << false;
+    QTest::newRow("QBoxLayout") << true;
+}
+
+/**
+ * @brief DockLayoutBench::benchmarkResize 100个控件时任务栏在两种长度之间切换，所有控件都要移动
+ */
+void DockLayoutBench::benchmarkResize()
+{
+    QFETCH(bool, boxLayout);
+
+    Strip strip(boxLayout);
+    fill(strip, ItemCount);
+    const QRect rect = strip.rect();
+    const QRect narrower = rect.adjusted(0, 0, -100, 0);
+
+    QBENCHMARK {
+        strip.layout(narrower);
+        strip.layout(rect);
+    }
+}
+
+QTEST_MAIN(DockLayoutBench)
+
+#include "docklayout_bench.moc"
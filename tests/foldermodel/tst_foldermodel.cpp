@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "item/components/foldermodel.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <QtTest>
+
+static const int FileCount = 2000;
+static const int BurstCount = 100;
+
+class FolderModelTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void initialScan();
+    void burst();
+    void removal();
+    void iconLoaded();
+    void modifiedWhileLoading();
+
+private:
+    void createFiles(const QString &prefix, int count);
+    QModelIndex indexOf(const FolderModel &model, const QString &name) const;
+    static bool isRed(const QVariant &decoration);
+
+private:
+    QTemporaryDir *m_dir;
+    int m_maxThreadCount;
+};
+
+void FolderModelTest::init()
+{
+    m_dir = new QTemporaryDir;
+    QVERIFY(m_dir->isValid());
+    m_maxThreadCount = QThreadPool::globalInstance()->maxThreadCount();
+}
+
+void FolderModelTest::cleanup()
+{
+    delete m_dir;
+    m_dir = nullptr;
+    QThreadPool::globalInstance()->setMaxThreadCount(m_maxThreadCount);
+}
+
+void FolderModelTest::createFiles(const QString &prefix, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        QFile file(QString("%1/%2-%3.txt").arg(m_dir->path()).arg(prefix).arg(i, 4, 10, QChar('0')));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+}
+
+QModelIndex FolderModelTest::indexOf(const FolderModel &model, const QString &name) const
+{
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const QModelIndex index = model.index(row);
+        if (index.data(Qt::DisplayRole).toString() == name)
+            return index;
+    }
+
+    return QModelIndex();
+}
+
+bool FolderModelTest::isRed(const QVariant &decoration)
+{
+    const QImage image = decoration.value<QPixmap>().toImage();
+    return !image.isNull() && image.pixelColor(image.rect().center()) == QColor(Qt::red);
+}
+
+/**
+ * @brief FolderModelTest::initialScan 2000个文件在后台扫描，一次插入，按名称排序
+ */
+void FolderModelTest::initialScan()
+{
+    createFiles("file", FileCount);
+
+    QElapsedTimer timer;
+    timer.start();
+    FolderModel model(m_dir->path());
+    QSignalSpy inserted(&model, &FolderModel::rowsInserted);
+    QTRY_COMPARE(model.rowCount(), FileCount);
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+
+    QCOMPARE(inserted.count(), 1);
+    for (int row = 1; row < model.rowCount(); ++row)
+        QVERIFY(model.index(row - 1).data().toString() < model.index(row).data().toString());
+}
+
+/**
+ * @brief FolderModelTest::burst 连续新建100个文件只重新扫描一次，新增的行合并为一次通知，已有的行不受影响
+ */
+void FolderModelTest::burst()
+{
+    createFiles("file", FileCount);
+    FolderModel model(m_dir->path());
+    QTRY_COMPARE(model.rowCount(), FileCount);
+
+    QSignalSpy inserted(&model, &FolderModel::rowsInserted);
+    QSignalSpy removed(&model, &FolderModel::rowsRemoved);
+    QSignalSpy changed(&model, &FolderModel::dataChanged);
+    QSignalSpy reset(&model, &FolderModel::modelReset);
+
+    QElapsedTimer timer;
+    timer.start();
+    createFiles("burst", BurstCount);
+    QTRY_COMPARE(model.rowCount(), FileCount + BurstCount);
+    QTest::setBenchmarkResult(timer.elapsed(), QTest::WalltimeMilliseconds);
+
+    // 新文件名排在一起，只有一段连续的插入
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(inserted.first().at(1).toInt(), 0);
+    QCOMPARE(inserted.first().at(2).toInt(), BurstCount - 1);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(changed.count(), 0);
+    QCOMPARE(reset.count(), 0);
+}
+
+/**
+ * @brief FolderModelTest::removal 删除的文件对应的行被移除
+ */
+void FolderModelTest::removal()
+{
+    createFiles("file", 10);
+    FolderModel model(m_dir->path());
+    QTRY_COMPARE(model.rowCount(), 10);
+
+    QVERIFY(QFile::remove(m_dir->filePath("file-0003.txt")));
+    QVERIFY(QFile::remove(m_dir->filePath("file-0004.txt")));
+    QTRY_COMPARE(model.rowCount(), 8);
+    QVERIFY(!indexOf(model, "file-0003.txt").isValid());
+    QVERIFY(indexOf(model, "file-0005.txt").isValid());
+}
+
+/**
+ * @brief FolderModelTest::iconLoaded 图片文件的缩略图在后台加载，完成后通知视图
+ */
+void FolderModelTest::iconLoaded()
+{
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    QVERIFY(image.save(m_dir->filePath("red.png")));
+
+    FolderModel model(m_dir->path());
+    QTRY_COMPARE(model.rowCount(), 1);
+
+    QSignalSpy changed(&model, &FolderModel::dataChanged);
+    QVERIFY(!isRed(model.index(0).data(Qt::DecorationRole)));
+    QTRY_COMPARE(changed.count(), 1);
+    QVERIFY(isRed(model.index(0).data(Qt::DecorationRole)));
+}
+
+/**
+ * @brief FolderModelTest::modifiedWhileLoading 图标加载期间文件被修改，旧结果丢弃后视图仍能拿到新的图标
+ */
+void FolderModelTest::modifiedWhileLoading()
+{
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    QVERIFY(image.save(m_dir->filePath("red.png")));
+
+    FolderModel model(m_dir->path());
+    QTRY_COMPARE(model.rowCount(), 1);
+
+    // 像视图一样，只在收到通知后重新读取图标
+    QVariant decoration = model.data(model.index(0), Qt::DecorationRole);
+    connect(&model, &FolderModel::dataChanged, &model, [&model, &decoration](const QModelIndex &topLeft) {
+        decoration = model.data(topLeft, Qt::DecorationRole);
+    });
+
+    // 只用一个工作线程，保证先完成重新扫描，再完成旧的图标加载
+    QThreadPool::globalInstance()->setMaxThreadCount(1);
+
+    QFile file(m_dir->filePath("red.png"));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(QDateTime::currentDateTime().addDays(-1), QFileDevice::FileModificationTime));
+    file.close();
+    model.refresh();
+
+    QTRY_VERIFY(isRed(decoration));
+}
+
+QTEST_MAIN(FolderModelTest)
+
+#include "tst_foldermodel.moc"
@@ -0,0 +1,190 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "item/components/hoverhighlighteffect.h"
+#include "util/utils.h"
+
+#include <QPainter>
+#include <QWidget>
+#include <QtTest>
+
+// 与任务栏上的图标大小相当
+static const QSize ItemSize(48, 48);
+
+/**
+ * @brief The ItemWidget class 绘制一块纯色，代替DockItem作为高亮的源控件
+ */
+class ItemWidget : public QWidget
+{
+public:
+    ItemWidget()
+        : m_color(QColor(40, 80, 120))
+    {
+        setFixedSize(ItemSize);
+    }
+
+    QColor color() const { return m_color; }
+    void setColor(const QColor &color) { m_color = color; }
+    // 与DockItem::paintKey相同的作用：标识当前绘制的内容
+    QString paintKey() const { return m_color.name(); }
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter painter(this);
+        painter.fillRect(rect(), m_color);
+    }
+
+private:
+    QColor m_color;
+};
+
+class HoverHighlightBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void notHighlighted();
+    void highlighted();
+    void reuseForSameKey();
+    void rebuildForNewKey();
+    void withoutKey();
+    void benchmarkRepaint_data();
+    void benchmarkRepaint();
+
+private:
+    QRgb renderedPixel();
+    void hover();
+
+private:
+    ItemWidget *m_item;
+    HoverHighlightEffect *m_effect;
+    QString m_key;
+};
+
+void HoverHighlightBench::init()
+{
+    m_item = new ItemWidget;
+    m_effect = new HoverHighlightEffect(m_item);
+    m_key.clear();
+    m_effect->setKeyFunction([this] { return m_key.isNull() ? m_item->paintKey() : m_key; });
+    m_item->setGraphicsEffect(m_effect);
+    m_item->show();
+}
+
+void HoverHighlightBench::cleanup()
+{
+    delete m_item;
+    m_item = nullptr;
+    m_effect = nullptr;
+}
+
+QRgb HoverHighlightBench::renderedPixel()
+{
+    return m_item->grab().toImage().pixel(ItemSize.width() / 2, ItemSize.height() / 2);
+}
+
+void HoverHighlightBench::hover()
+{
+    QEvent enter(QEvent::Enter);
+    QCoreApplication::sendEvent(m_item, &enter);
+}
+
+static QRgb lighter(const QColor &color)
+{
+    QPixmap pixmap(1, 1);
+    pixmap.fill(color);
+    return Utils::lighterEffect(pixmap).toImage().pixel(0, 0);
+}
+
+/**
+ * @brief HoverHighlightBench::notHighlighted 未悬停时原样绘制
+ */
+void HoverHighlightBench::notHighlighted()
+{
+    QCOMPARE(renderedPixel(), m_item->color().rgb());
+}
+
+/**
+ * @brief HoverHighlightBench::highlighted 悬停时绘制提亮后的结果，离开后恢复
+ */
+void HoverHighlightBench::highlighted()
+{
+    hover();
+    QCOMPARE(renderedPixel(), lighter(m_item->color()));
+
+    QEvent leave(QEvent::Leave);
+    QCoreApplication::sendEvent(m_item, &leave);
+    QCOMPARE(renderedPixel(), m_item->color().rgb());
+}
+
+/**
+ * @brief HoverHighlightBench::reuseForSameKey 标识不变时直接绘制上次的高亮图，不再重新计算
+ */
+void HoverHighlightBench::reuseForSameKey()
+{
+    m_key = "fixed";
+    hover();
+    const QRgb before = renderedPixel();
+
+    // 内容变了但标识没变，仍然是旧的高亮图，说明没有重新计算
+    m_item->setColor(QColor(200, 40, 40));
+    QCOMPARE(renderedPixel(), before);
+}
+
+/**
+ * @brief HoverHighlightBench::rebuildForNewKey 标识变化后重新计算
+ */
+void HoverHighlightBench::rebuildForNewKey()
+{
+    hover();
+    renderedPixel();
+
+    m_item->setColor(QColor(200, 40, 40));
+    QCOMPARE(renderedPixel(), lighter(m_item->color()));
+}
+
+/**
+ * @brief HoverHighlightBench::withoutKey 标识为空时每次都重新计算
+ */
+void HoverHighlightBench::withoutKey()
+{
+    m_key = "";
+    hover();
+    renderedPixel();
+
+    m_item->setColor(QColor(200, 40, 40));
+    QCOMPARE(renderedPixel(), lighter(m_item->color()));
+}
+
+void HoverHighlightBench::benchmarkRepaint_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("same key") << true;
+    QTest::newRow("no key") << false;
+}
+
+/**
+ * @brief HoverHighlightBench::benchmarkRepaint 悬停期间的重绘：内容不变时复用高亮图，对比原先每次都重新提亮
+ */
+void HoverHighlightBench::benchmarkRepaint()
+{
+    QFETCH(bool, cached);
+
+    m_key = cached ? "fixed" : "";
+    hover();
+    QPixmap target(ItemSize);
+
+    QBENCHMARK {
+        m_item->render(&target);
+    }
+}
+
+QTEST_MAIN(HoverHighlightBench)
+
+#include "hoverhighlight_bench.moc"
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "item/components/iconpixmap.h"
+
+#include <QIconEngine>
+#include <QPainter>
+#include <QtTest>
+
+// 与AppItem一致：图标为控件宽度的0.85倍
+static const int ItemWidth = 48;
+static const int IconSize = int(ItemWidth * .85);
+static const int ItemCount = 100;
+static const int Repaints = 1000;
+
+namespace {
+
+// 主题图标通常提供比任务栏上大得多的尺寸
+QIcon sampleIcon(int seed)
+{
+    QPixmap pixmap(256, 256);
+    pixmap.fill(QColor::fromHsv(seed * 3 % 360, 200, 200));
+    return QIcon(pixmap);
+}
+
+// 记录渲染次数。QIcon自带的引擎会把缩放结果放进QPixmapCache，重复渲染也返回同一张图，无法据此判断
+class CountingIconEngine : public QIconEngine
+{
+public:
+    explicit CountingIconEngine(int *count) : m_count(count) {}
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode, QIcon::State) override
+    {
+        painter->fillRect(rect, Qt::red);
+    }
+
+    QPixmap pixmap(const QSize &size, QIcon::Mode, QIcon::State) override
+    {
+        ++*m_count;
+        QPixmap pixmap(size);
+        pixmap.fill(Qt::red);
+        return pixmap;
+    }
+
+    QIconEngine *clone() const override { return new CountingIconEngine(m_count); }
+
+private:
+    int *m_count;
+};
+
+// 原先AppItem::paintEvent中每次重绘的写法
+QPixmap perPaintPixmap(const QIcon &icon)
+{
+    return icon.pixmap(IconSize).scaled(IconSize, IconSize);
+}
+
+}
+
+class IconPixmapBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesPerPaint();
+    void reuse();
+    void rebuild();
+    void benchmarkRepaint_data();
+    void benchmarkRepaint();
+};
+
+/**
+ * @brief IconPixmapBench::matchesPerPaint 预先渲染的结果与原先每次重绘时生成的图标相同
+ */
+void IconPixmapBench::matchesPerPaint()
+{
+    const QIcon icon = sampleIcon(1);
+    IconPixmap iconPixmap;
+
+    const QPixmap &pixmap = iconPixmap.pixmap(icon, IconSize, 1);
+    QCOMPARE(pixmap.toImage(), perPaintPixmap(icon).toImage());
+    QCOMPARE(iconPixmap.sourceRect(), QRectF(icon.pixmap(IconSize).rect()));
+}
+
+/**
+ * @brief IconPixmapBench::reuse 图标、尺寸与缩放比都不变时不重新渲染
+ */
+void IconPixmapBench::reuse()
+{
+    int renders = 0;
+    const QIcon icon(new CountingIconEngine(&renders));
+    IconPixmap iconPixmap;
+
+    iconPixmap.pixmap(icon, IconSize, 1);
+    QCOMPARE(renders, 1);
+
+    for (int i = 0; i < Repaints; ++i)
+        iconPixmap.pixmap(QIcon(icon), IconSize, 1);
+    QCOMPARE(renders, 1);
+}
+
+/**
+ * @brief IconPixmapBench::rebuild 更换图标、改变尺寸或缩放比，以及清除之后都重新渲染
+ */
+void IconPixmapBench::rebuild()
+{
+    int renders = 0;
+    const QIcon icon(new CountingIconEngine(&renders));
+    IconPixmap iconPixmap;
+    iconPixmap.pixmap(icon, IconSize, 1);
+
+    QCOMPARE(iconPixmap.pixmap(icon, IconSize + 1, 1).size(), QSize(IconSize + 1, IconSize + 1));
+    QCOMPARE(renders, 2);
+
+    iconPixmap.pixmap(icon, IconSize + 1, 2);
+    QCOMPARE(renders, 3);
+
+    const QIcon other(new CountingIconEngine(&renders));
+    iconPixmap.pixmap(other, IconSize + 1, 2);
+    QCOMPARE(renders, 4);
+
+    iconPixmap.clear();
+    iconPixmap.pixmap(other, IconSize + 1, 2);
+    QCOMPARE(renders, 5);
+}
+
+void IconPixmapBench::benchmarkRepaint_data()
+{
+    QTest::addColumn<bool>("prerendered");
+
+    QTest::newRow("prerendered") << true;
+    QTest::newRow("per-paint") << false;
+}
+
+/**
+ * @brief IconPixmapBench::benchmarkRepaint 100个应用各重绘1000次，相当于悬停动画期间任务栏的重绘
+ */
+void IconPixmapBench::benchmarkRepaint()
+{
+    QFETCH(bool, prerendered);
+
+    QList<QIcon> icons;
+    for (int i = 0; i < ItemCount; ++i)
+        icons.append(sampleIcon(i));
+    QVector<IconPixmap> iconPixmaps(ItemCount);
+    QImage target(ItemWidth, ItemWidth, QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK_ONCE {
+        for (int repaint = 0; repaint < Repaints; ++repaint) {
+            for (int i = 0; i < ItemCount; ++i) {
+                QPainter painter(&target);
+                if (prerendered)
+                    painter.drawPixmap(0, 0, iconPixmaps[i].pixmap(icons.at(i), IconSize, 1));
+                else
+                    painter.drawPixmap(0, 0, perPaintPixmap(icons.at(i)));
+            }
+        }
+    }
+}
+
+QTEST_MAIN(IconPixmapBench)
+
+#include "iconpixmap_bench.moc"
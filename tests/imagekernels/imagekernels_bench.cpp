@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "util/imagekernels.h"
+
+#include <QColor>
+#include <QImage>
+#include <QRandomGenerator>
+#include <QVector>
+#include <QtTest>
+
+namespace {
+
+// 原先XUtils::getWindowIconNameX11中的逐像素写法
+uint32_t scalarPremultiply(uint32_t pixel)
+{
+    const uint32_t a = pixel >> 24;
+    return a << 24 | (((pixel >> 16) & 0xff) * a / 255) << 16 | (((pixel >> 8) & 0xff) * a / 255) << 8 | (pixel & 0xff) * a / 255;
+}
+
+// 原先Utils::lighterEffect中的逐像素写法
+uint32_t scalarLighten(uint32_t pixel, int factor)
+{
+    return qAlpha(pixel) == 0xff ? QColor::fromRgba(pixel).lighter(factor).rgba() : pixel;
+}
+
+int channelDistance(uint32_t lhs, uint32_t rhs)
+{
+    int distance = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+        distance = qMax(distance, qAbs(int((lhs >> shift) & 0xff) - int((rhs >> shift) & 0xff)));
+
+    return distance;
+}
+
+// 随机像素之外加上各种边界值，个数不是4的倍数，覆盖向量化之后的尾部
+QVector<uint32_t> samplePixels(int count)
+{
+    QVector<uint32_t> pixels = {0x00000000, 0xffffffff, 0xff000000, 0xff808080, 0xffff0000, 0xff00ff00,
+                                0xff0000ff, 0xfffefefe, 0xff010203, 0x80ff8000, 0x01ffffff, 0xfe123456};
+    QRandomGenerator generator(20231018);
+    while (pixels.size() < count) {
+        uint32_t pixel = generator.generate();
+        // 一半的像素不透明，才能覆盖提亮的向量化路径
+        if (generator.bounded(2))
+            pixel |= 0xff000000;
+        pixels.append(pixel);
+    }
+
+    return pixels;
+}
+
+}
+
+class ImageKernelsBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void premultiply();
+    void premultiplyMatchesQImage();
+    void lighten_data();
+    void lighten();
+    void benchmarkPremultiply_data();
+    void benchmarkPremultiply();
+    void benchmarkLighten_data();
+    void benchmarkLighten();
+};
+
+/**
+ * @brief ImageKernelsBench::premultiply 与原来的逐像素写法逐位一致
+ */
+void ImageKernelsBench::premultiply()
+{
+    const QVector<uint32_t> src = samplePixels(100003);
+    QVector<uint32_t> dst(src.size());
+    ImageKernels::premultiply(src.constData(), dst.data(), src.size());
+
+    for (int i = 0; i < src.size(); ++i)
+        QCOMPARE(dst.at(i), scalarPremultiply(src.at(i)));
+
+    // 允许原地转换
+    QVector<uint32_t> inPlace = src;
+    ImageKernels::premultiply(inPlace.constData(), inPlace.data(), inPlace.size());
+    QCOMPARE(inPlace, dst);
+}
+
+/**
+ * @brief ImageKernelsBench::premultiplyMatchesQImage Qt四舍五入，这里截断，每个通道最多相差1
+ */
+void ImageKernelsBench::premultiplyMatchesQImage()
+{
+    QVector<uint32_t> src = samplePixels(4099);
+    const QImage image(reinterpret_cast<const uchar *>(src.constData()), src.size(), 1, QImage::Format_ARGB32);
+    const QImage reference = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    QVector<uint32_t> dst(src.size());
+    ImageKernels::premultiply(src.constData(), dst.data(), src.size());
+
+    const uint32_t *expected = reinterpret_cast<const uint32_t *>(reference.constScanLine(0));
+    for (int i = 0; i < dst.size(); ++i)
+        QVERIFY2(channelDistance(dst.at(i), expected[i]) <= 1, qPrintable(QString::number(src.at(i), 16)));
+}
+
+void ImageKernelsBench::lighten_data()
+{
+    QTest::addColumn<int>("factor");
+
+    QTest::newRow("hover") << 120;
+    QTest::newRow("150") << 150;
+    QTest::newRow("200") << 200;
+    QTest::newRow("unchanged") << 100;
+}
+
+/**
+ * @brief ImageKernelsBench::lighten 半透明像素保持不变，不透明像素与QColor::lighter每个通道最多相差2（定点与16位HSV的舍入差异）
+ */
+void ImageKernelsBench::lighten()
+{
+    QFETCH(int, factor);
+
+    const QVector<uint32_t> src = samplePixels(100003);
+    QVector<uint32_t> dst = src;
+    ImageKernels::lighten(dst.data(), dst.size(), factor);
+
+    for (int i = 0; i < src.size(); ++i) {
+        if (qAlpha(src.at(i)) != 0xff) {
+            QCOMPARE(dst.at(i), src.at(i));
+            continue;
+        }
+
+        QVERIFY2(channelDistance(dst.at(i), scalarLighten(src.at(i), factor)) <= 2, qPrintable(QString::number(src.at(i), 16)));
+    }
+}
+
+void ImageKernelsBench::benchmarkPremultiply_data()
+{
+    QTest::addColumn<bool>("scalar");
+
+    QTest::newRow("scalar") << true;
+    QTest::newRow("kernel") << false;
+}
+
+void ImageKernelsBench::benchmarkPremultiply()
+{
+    QFETCH(bool, scalar);
+
+    // 一张256x256的窗口图标
+    const QVector<uint32_t> src = samplePixels(256 * 256);
+    QVector<uint32_t> dst(src.size());
+
+    if (scalar) {
+        QBENCHMARK {
+            for (int i = 0; i < src.size(); ++i)
+                dst[i] = scalarPremultiply(src.at(i));
+        }
+    } else {
+        QBENCHMARK {
+            ImageKernels::premultiply(src.constData(), dst.data(), src.size());
+        }
+    }
+}
+
+void ImageKernelsBench::benchmarkLighten_data()
+{
+    QTest::addColumn<bool>("scalar");
+
+    QTest::newRow("scalar") << true;
+    QTest::newRow("kernel") << false;
+}
+
+void ImageKernelsBench::benchmarkLighten()
+{
+    QFETCH(bool, scalar);
+
+    // 一个2倍缩放下的任务栏图标
+    const QVector<uint32_t> src = samplePixels(96 * 96);
+    QVector<uint32_t> pixels;
+
+    if (scalar) {
+        QBENCHMARK {
+            pixels = src;
+            for (int i = 0; i < pixels.size(); ++i)
+                pixels[i] = scalarLighten(pixels.at(i), 120);
+        }
+    } else {
+        QBENCHMARK {
+            pixels = src;
+            ImageKernels::lighten(pixels.data(), pixels.size(), 120);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(ImageKernelsBench)
+
+#include "imagekernels_bench.moc"
@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "util/windowcapture.h"
+
+#include <QPainter>
+#include <QtTest>
+
+// 全屏窗口的截图，四周带有窗口阴影
+static const QSize CaptureSize(1920, 1080);
+static const QMargins ShadowMargins(20, 20, 20, 20);
+static const int MinMipmapSize = 64;
+
+namespace {
+
+QImage sampleCapture()
+{
+    QImage image(CaptureSize, QImage::Format_ARGB32);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    QLinearGradient gradient(0, 0, CaptureSize.width(), CaptureSize.height());
+    gradient.setColorAt(0, QColor(30, 90, 160));
+    gradient.setColorAt(1, QColor(220, 180, 60));
+    painter.fillRect(image.rect().marginsRemoved(ShadowMargins), gradient);
+
+    return image;
+}
+
+// 两张同样大小的图片各通道的平均差
+qreal meanDifference(const QImage &a, const QImage &b)
+{
+    const QImage x = a.convertToFormat(QImage::Format_ARGB32);
+    const QImage y = b.convertToFormat(QImage::Format_ARGB32);
+
+    qint64 sum = 0;
+    for (int row = 0; row < x.height(); ++row) {
+        const QRgb *px = reinterpret_cast<const QRgb *>(x.constScanLine(row));
+        const QRgb *py = reinterpret_cast<const QRgb *>(y.constScanLine(row));
+        for (int col = 0; col < x.width(); ++col) {
+            sum += qAbs(qRed(px[col]) - qRed(py[col])) + qAbs(qGreen(px[col]) - qGreen(py[col]))
+                    + qAbs(qBlue(px[col]) - qBlue(py[col])) + qAbs(qAlpha(px[col]) - qAlpha(py[col]));
+        }
+    }
+
+    return qreal(sum) / (x.width() * x.height() * 4);
+}
+
+// 任务栏窗口项、预览以及悬停放大后的预览大小（逻辑像素）与缩放比
+const QList<QPair<QSizeF, qreal>> TargetSizes = {
+    {QSizeF(38, 38), 1.},
+    {QSizeF(180, 100), 1.},
+    {QSizeF(180, 100), 2.},
+    {QSizeF(500, 300), 1.},
+};
+
+QString sizeName(const QPair<QSizeF, qreal> &size)
+{
+    return QString("%1x%2@%3").arg(size.first.width()).arg(size.first.height()).arg(size.second);
+}
+
+}
+
+class MipmapsBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void levels();
+    void matchesDirect_data();
+    void matchesDirect();
+    void benchmarkMipmaps();
+    void benchmarkThumbnail_data();
+    void benchmarkThumbnail();
+
+private:
+    QImage m_capture;
+    QRect m_contentRect;
+    QVector<QImage> m_mipmaps;
+};
+
+void MipmapsBench::initTestCase()
+{
+    m_capture = sampleCapture();
+    m_contentRect = m_capture.rect().marginsRemoved(ShadowMargins);
+    m_mipmaps = WindowCapture::mipmaps(m_capture);
+}
+
+/**
+ * @brief MipmapsBench::levels 每级宽高减半，直到短边不足MinMipmapSize的两倍
+ */
+void MipmapsBench::levels()
+{
+    QVERIFY(m_mipmaps.size() > 1);
+    QCOMPARE(m_mipmaps.first().size(), CaptureSize);
+    QCOMPARE(m_mipmaps.first().format(), QImage::Format_ARGB32_Premultiplied);
+
+    for (int i = 1; i < m_mipmaps.size(); ++i)
+        QCOMPARE(m_mipmaps.at(i).size(), QSize(m_mipmaps.at(i - 1).width() / 2, m_mipmaps.at(i - 1).height() / 2));
+
+    const QSize last = m_mipmaps.last().size();
+    QVERIFY(qMin(last.width(), last.height()) >= MinMipmapSize);
+    QVERIFY(qMin(last.width(), last.height()) / 2 < MinMipmapSize);
+}
+
+void MipmapsBench::matchesDirect_data()
+{
+    QTest::addColumn<QSizeF>("size");
+    QTest::addColumn<qreal>("ratio");
+
+    for (const auto &size : TargetSizes)
+        QTest::newRow(qPrintable(sizeName(size))) << size.first << size.second;
+}
+
+/**
+ * @brief MipmapsBench::matchesDirect 从mipmap缩放的结果与从原图缩放的大小、有效区域相同，内容接近
+ */
+void MipmapsBench::matchesDirect()
+{
+    QFETCH(QSizeF, size);
+    QFETCH(qreal, ratio);
+
+    const WindowThumbnail direct = WindowCapture::thumbnail(m_capture, m_contentRect, size, ratio);
+    const WindowThumbnail mipmapped = WindowCapture::thumbnail(m_mipmaps, m_contentRect, size, ratio);
+
+    QCOMPARE(mipmapped.image.size(), direct.image.size());
+    QCOMPARE(mipmapped.image.devicePixelRatio(), ratio);
+    QVERIFY(qAbs(mipmapped.rect.x() - direct.rect.x()) < 1);
+    QVERIFY(qAbs(mipmapped.rect.y() - direct.rect.y()) < 1);
+    QVERIFY(qAbs(mipmapped.rect.width() - direct.rect.width()) < 1);
+    QVERIFY(qAbs(mipmapped.rect.height() - direct.rect.height()) < 1);
+    QVERIFY(meanDifference(mipmapped.image, direct.image) < 4);
+}
+
+/**
+ * @brief MipmapsBench::benchmarkMipmaps 每次截图生成mipmap的开销，由之后每次缩放节省的时间分摊
+ */
+void MipmapsBench::benchmarkMipmaps()
+{
+    QBENCHMARK {
+        WindowCapture::mipmaps(m_capture);
+    }
+}
+
+void MipmapsBench::benchmarkThumbnail_data()
+{
+    QTest::addColumn<QSizeF>("size");
+    QTest::addColumn<qreal>("ratio");
+    QTest::addColumn<bool>("mipmapped");
+
+    for (const auto &size : TargetSizes) {
+        QTest::newRow(qPrintable(sizeName(size) + " direct")) << size.first << size.second << false;
+        QTest::newRow(qPrintable(sizeName(size) + " mipmap")) << size.first << size.second << true;
+    }
+}
+
+/**
+ * @brief MipmapsBench::benchmarkThumbnail 不同目标大小下交付一张缩略图的耗时，对比每次从原图缩放
+ */
+void MipmapsBench::benchmarkThumbnail()
+{
+    QFETCH(QSizeF, size);
+    QFETCH(qreal, ratio);
+    QFETCH(bool, mipmapped);
+
+    if (mipmapped) {
+        QBENCHMARK {
+            WindowCapture::thumbnail(m_mipmaps, m_contentRect, size, ratio);
+        }
+    } else {
+        QBENCHMARK {
+            WindowCapture::thumbnail(m_capture, m_contentRect, size, ratio);
+        }
+    }
+}
+
+QTEST_MAIN(MipmapsBench)
+
+#include "mipmaps_bench.moc"
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "util/trashmonitor.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+// 超过inotify默认的队列长度（16384），事件来不及处理时会溢出
+static const int ManyEntries = 50000;
+
+class TrashMonitorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void initialScan();
+    void incremental();
+    void overflowRescan();
+    void noDoubleCount();
+    void emptied();
+
+private:
+    QString filesPath() const { return m_trash->path() + "/files"; }
+    void createEntries(int first, int count, const QString &dir = QString());
+    void removeEntries(int first, int count);
+
+private:
+    QTemporaryDir *m_trash;
+};
+
+void TrashMonitorTest::init()
+{
+    m_trash = new QTemporaryDir;
+    QVERIFY(m_trash->isValid());
+    QVERIFY(QDir(m_trash->path()).mkdir("files"));
+    QVERIFY(QDir(m_trash->path()).mkdir("info"));
+}
+
+void TrashMonitorTest::cleanup()
+{
+    delete m_trash;
+    m_trash = nullptr;
+}
+
+void TrashMonitorTest::createEntries(int first, int count, const QString &dir)
+{
+    const QString path = dir.isEmpty() ? filesPath() : dir;
+    for (int i = first; i < first + count; ++i) {
+        QFile file(QString("%1/entry-%2").arg(path).arg(i));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+}
+
+void TrashMonitorTest::removeEntries(int first, int count)
+{
+    for (int i = first; i < first + count; ++i)
+        QVERIFY(QFile::remove(QString("%1/entry-%2").arg(filesPath()).arg(i)));
+}
+
+void TrashMonitorTest::initialScan()
+{
+    createEntries(0, ManyEntries);
+
+    TrashMonitor monitor(m_trash->path());
+    QCOMPARE(monitor.count(), ManyEntries);
+    QVERIFY(!monitor.isEmpty());
+}
+
+void TrashMonitorTest::incremental()
+{
+    createEntries(0, 10);
+
+    TrashMonitor monitor(m_trash->path());
+    QSignalSpy spy(&monitor, &TrashMonitor::countChanged);
+    QCOMPARE(monitor.count(), 10);
+
+    createEntries(10, 5);
+    QTRY_COMPARE(monitor.count(), 15);
+
+    removeEntries(0, 3);
+    QTRY_COMPARE(monitor.count(), 12);
+
+    // 目录内改名不改变项目数
+    QVERIFY(QFile::rename(filesPath() + "/entry-10", filesPath() + "/renamed"));
+    QTest::qWait(100);
+    QCOMPARE(monitor.count(), 12);
+
+    // 从外部移入、移出
+    createEntries(100, 1, m_trash->path());
+    QVERIFY(QFile::rename(m_trash->path() + "/entry-100", filesPath() + "/entry-100"));
+    QTRY_COMPARE(monitor.count(), 13);
+    QVERIFY(QFile::rename(filesPath() + "/renamed", m_trash->path() + "/renamed"));
+    QTRY_COMPARE(monitor.count(), 12);
+
+    QCOMPARE(spy.last().first().toInt(), 12);
+}
+
+/**
+ * @brief TrashMonitorTest::overflowRescan 不处理事件时一次放入大量项目，事件队列溢出后重新遍历
+ */
+void TrashMonitorTest::overflowRescan()
+{
+    TrashMonitor monitor(m_trash->path());
+    QVERIFY(monitor.isEmpty());
+
+    createEntries(0, ManyEntries);
+    QTRY_COMPARE_WITH_TIMEOUT(monitor.count(), ManyEntries, 30000);
+
+    removeEntries(0, ManyEntries);
+    QTRY_COMPARE_WITH_TIMEOUT(monitor.count(), 0, 30000);
+}
+
+/**
+ * @brief TrashMonitorTest::noDoubleCount 遍历已经包含的项目，随后处理它们排队的事件时不能再计一次
+ */
+void TrashMonitorTest::noDoubleCount()
+{
+    TrashMonitor monitor(m_trash->path());
+
+    createEntries(0, 100);
+    monitor.rescan();
+    QCOMPARE(monitor.count(), 100);
+
+    // 处理排队的IN_CREATE
+    QTest::qWait(200);
+    QCOMPARE(monitor.count(), 100);
+
+    removeEntries(0, 50);
+    QTRY_COMPARE(monitor.count(), 50);
+}
+
+/**
+ * @brief TrashMonitorTest::emptied 清空回收站时files目录被删除后重建，之后的变化仍能收到
+ */
+void TrashMonitorTest::emptied()
+{
+    createEntries(0, 20);
+
+    TrashMonitor monitor(m_trash->path());
+    QCOMPARE(monitor.count(), 20);
+
+    QVERIFY(QDir(filesPath()).removeRecursively());
+    QVERIFY(QDir(m_trash->path()).mkdir("files"));
+    QTRY_COMPARE(monitor.count(), 0);
+
+    createEntries(0, 3);
+    QTRY_COMPARE(monitor.count(), 3);
+}
+
+QTEST_GUILESS_MAIN(TrashMonitorTest)
+
+#include "tst_trashmonitor.moc"
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "taskmanager/windowicon.h"
+#include "util/utils.h"
+
+#include <QBuffer>
+#include <QPixmapCache>
+#include <QtTest>
+
+#include <algorithm>
+
+// 按任务栏显示尺寸下载的窗口图标，以及AppItem绘制时的大小
+static const uint32_t SourceSize = 64;
+static const int DisplaySize = 40;
+
+namespace {
+
+// 带有半透明边缘的非预乘ARGB图标
+std::vector<uint32_t> samplePixels(uint32_t seed)
+{
+    std::vector<uint32_t> pixels(SourceSize * SourceSize);
+    for (uint32_t y = 0; y < SourceSize; ++y) {
+        for (uint32_t x = 0; x < SourceSize; ++x) {
+            const uint32_t edge = std::min(std::min(x, y), std::min(SourceSize - 1 - x, SourceSize - 1 - y));
+            const uint32_t alpha = std::min(255u, edge * 32);
+            pixels[y * SourceSize + x] = qRgba(int((x * 4 + seed) & 0xff), int((y * 4) & 0xff), int(seed & 0xff), int(alpha));
+        }
+    }
+
+    return pixels;
+}
+
+// 原先的做法：拷贝为QImage，编码为PNG与base64的data URI，由Utils::getIcon计算MD5并解码后缩放
+QPixmap dataUriIcon(const std::vector<uint32_t> &pixels)
+{
+    const QImage image = QImage(reinterpret_cast<const uchar *>(pixels.data()), int(SourceSize), int(SourceSize), QImage::Format_ARGB32).copy();
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    const QString uri = QString("%1,%2").arg("data:image/png:base64").arg(QString(buffer.data().toBase64()));
+
+    return Utils::getIcon(uri, DisplaySize, 1);
+}
+
+QPixmap argbIcon(const std::vector<uint32_t> &pixels)
+{
+    const WindowIcon icon = WindowIcon::fromPixels(std::vector<uint32_t>(pixels), SourceSize, SourceSize);
+    return Utils::getIcon(icon.image, icon.key, DisplaySize, 1);
+}
+
+// 两张图片各通道的最大差
+int maxDifference(const QImage &a, const QImage &b)
+{
+    const QImage x = a.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const QImage y = b.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    int result = 0;
+    for (int row = 0; row < x.height(); ++row) {
+        const QRgb *px = reinterpret_cast<const QRgb *>(x.constScanLine(row));
+        const QRgb *py = reinterpret_cast<const QRgb *>(y.constScanLine(row));
+        for (int col = 0; col < x.width(); ++col) {
+            result = std::max({result, qAbs(qRed(px[col]) - qRed(py[col])), qAbs(qGreen(px[col]) - qGreen(py[col])),
+                               qAbs(qBlue(px[col]) - qBlue(py[col])), qAbs(qAlpha(px[col]) - qAlpha(py[col]))});
+        }
+    }
+
+    return result;
+}
+
+}
+
+class WindowIconBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    void fromPixels();
+    void invalidSize();
+    void key();
+    void matchesDataUri();
+    void benchmarkUpdate_data();
+    void benchmarkUpdate();
+};
+
+void WindowIconBench::cleanup()
+{
+    QPixmapCache::clear();
+}
+
+/**
+ * @brief WindowIconBench::fromPixels 接管像素后就地预乘，结果与Qt的格式转换一致（截断与四舍五入最多相差1）
+ */
+void WindowIconBench::fromPixels()
+{
+    const std::vector<uint32_t> pixels = samplePixels(1);
+    const QImage expected = QImage(reinterpret_cast<const uchar *>(pixels.data()), int(SourceSize), int(SourceSize), QImage::Format_ARGB32)
+            .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    std::vector<uint32_t> moved = pixels;
+    const uchar *data = reinterpret_cast<const uchar *>(moved.data());
+    const WindowIcon icon = WindowIcon::fromPixels(std::move(moved), SourceSize, SourceSize);
+
+    QCOMPARE(icon.image.format(), QImage::Format_ARGB32_Premultiplied);
+    QCOMPARE(icon.image.size(), QSize(SourceSize, SourceSize));
+    QCOMPARE(icon.image.constBits(), data);
+    QVERIFY(maxDifference(icon.image, expected) <= 1);
+}
+
+/**
+ * @brief WindowIconBench::invalidSize 像素个数与宽高不符时返回空图标
+ */
+void WindowIconBench::invalidSize()
+{
+    QVERIFY(WindowIcon::fromPixels(samplePixels(1), SourceSize, SourceSize + 1).isNull());
+    QVERIFY(WindowIcon::fromPixels(samplePixels(1), 0, SourceSize).isNull());
+    QVERIFY(WindowIcon::fromPixels(std::vector<uint32_t>(), 0, 0).isNull());
+}
+
+/**
+ * @brief WindowIconBench::key 相同的像素得到相同的标识，内容变化后标识随之变化
+ */
+void WindowIconBench::key()
+{
+    const WindowIcon icon = WindowIcon::fromPixels(samplePixels(1), SourceSize, SourceSize);
+    QVERIFY(icon == WindowIcon::fromPixels(samplePixels(1), SourceSize, SourceSize));
+    QVERIFY(icon != WindowIcon::fromPixels(samplePixels(2), SourceSize, SourceSize));
+}
+
+/**
+ * @brief WindowIconBench::matchesDataUri 显示的图标与原先经过PNG编码的结果相同
+ */
+void WindowIconBench::matchesDataUri()
+{
+    const std::vector<uint32_t> pixels = samplePixels(1);
+    const QPixmap expected = dataUriIcon(pixels);
+    const QPixmap pixmap = argbIcon(pixels);
+
+    QCOMPARE(pixmap.size(), expected.size());
+    QVERIFY(maxDifference(pixmap.toImage(), expected.toImage()) <= 2);
+}
+
+void WindowIconBench::benchmarkUpdate_data()
+{
+    QTest::addColumn<bool>("argb");
+
+    QTest::newRow("data uri") << false;
+    QTest::newRow("argb") << true;
+}
+
+/**
+ * @brief WindowIconBench::benchmarkUpdate 每次图标更新的CPU开销：从X返回的像素到可绘制的图标，每次都是新的内容，不命中缓存
+ */
+void WindowIconBench::benchmarkUpdate()
+{
+    QFETCH(bool, argb);
+
+    const std::vector<uint32_t> pixels = samplePixels(1);
+    QBENCHMARK {
+        QPixmapCache::clear();
+        if (argb)
+            argbIcon(pixels);
+        else
+            dataUriIcon(pixels);
+    }
+}
+
+QTEST_MAIN(WindowIconBench)
+
+#include "windowicon_bench.moc"
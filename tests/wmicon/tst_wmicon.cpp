@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "taskmanager/wmicon.h"
+
+#include <QtTest>
+
+#include <algorithm>
+
+// 常见应用提供的图标尺寸
+static const std::vector<uint32_t> IconSizes = {16, 24, 32, 48, 64, 128, 256, 512};
+
+/**
+ * @brief The FakeProperty class 模拟_NET_WM_ICON属性，按GetProperty的方式读取，并统计传输的字节数
+ */
+class FakeProperty
+{
+public:
+    void append(uint32_t width, uint32_t height)
+    {
+        m_values.push_back(width);
+        m_values.push_back(height);
+        // 像素值记录所在的图标，便于检查读取的位置
+        m_values.insert(m_values.end(), size_t(width) * height, width << 16 | height);
+    }
+
+    void truncate(size_t count) { m_values.resize(m_values.size() - count); }
+
+    uint64_t totalBytes() const { return m_values.size() * sizeof(uint32_t); }
+    uint64_t transferredBytes() const { return m_transferred; }
+
+    WMIconSizeReader reader()
+    {
+        return [this](uint32_t offset, uint32_t size[2], uint64_t &bytesAfter) {
+            if (offset + 2 > m_values.size())
+                return false;
+
+            m_transferred += 2 * sizeof(uint32_t);
+            size[0] = m_values.at(offset);
+            size[1] = m_values.at(offset + 1);
+            bytesAfter = (m_values.size() - offset - 2) * sizeof(uint32_t);
+            return true;
+        };
+    }
+
+    // 与getWMIcon一样只下载选中图标的像素
+    std::vector<uint32_t> pixels(const WMIconHeader &header)
+    {
+        const size_t size = size_t(header.width) * header.height;
+        m_transferred += size * sizeof(uint32_t);
+        return std::vector<uint32_t>(m_values.begin() + header.offset, m_values.begin() + header.offset + size);
+    }
+
+private:
+    std::vector<uint32_t> m_values;
+    uint64_t m_transferred = 0;
+};
+
+class WMIconTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void walk();
+    void walkEmpty();
+    void walkTruncated();
+    void walkZeroSize();
+    void pick_data();
+    void pick();
+    void pickNonSquare();
+    void transferredBytes();
+};
+
+/**
+ * @brief WMIconTest::walk 每个图标的偏移指向其像素数据，宽高与属性中的一致
+ */
+void WMIconTest::walk()
+{
+    FakeProperty property;
+    for (uint32_t size : IconSizes)
+        property.append(size, size);
+
+    const std::vector<WMIconHeader> headers = walkWMIconHeaders(property.reader());
+    QCOMPARE(headers.size(), IconSizes.size());
+
+    uint32_t offset = 0;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        QCOMPARE(headers.at(i).width, IconSizes.at(i));
+        QCOMPARE(headers.at(i).height, IconSizes.at(i));
+        QCOMPARE(headers.at(i).offset, offset + 2);
+        QCOMPARE(property.pixels(headers.at(i)).front(), IconSizes.at(i) << 16 | IconSizes.at(i));
+        offset += 2 + IconSizes.at(i) * IconSizes.at(i);
+    }
+}
+
+/**
+ * @brief WMIconTest::walkEmpty 没有图标或只有不完整的头部时结果为空
+ */
+void WMIconTest::walkEmpty()
+{
+    FakeProperty property;
+    QVERIFY(walkWMIconHeaders(property.reader()).empty());
+
+    property.append(16, 16);
+    property.truncate(16 * 16 + 1);
+    QVERIFY(walkWMIconHeaders(property.reader()).empty());
+}
+
+/**
+ * @brief WMIconTest::walkTruncated 最后一个图标的像素不完整时丢弃它，之前的图标不受影响
+ */
+void WMIconTest::walkTruncated()
+{
+    FakeProperty property;
+    property.append(16, 16);
+    property.append(32, 32);
+    property.append(48, 48);
+    property.truncate(1);
+
+    const std::vector<WMIconHeader> headers = walkWMIconHeaders(property.reader());
+    QCOMPARE(headers.size(), size_t(2));
+    QCOMPARE(headers.back().width, 32u);
+}
+
+/**
+ * @brief WMIconTest::walkZeroSize 宽高为0的图标之后的数据无法定位，停止读取
+ */
+void WMIconTest::walkZeroSize()
+{
+    FakeProperty property;
+    property.append(16, 16);
+    property.append(0, 32);
+    property.append(48, 48);
+
+    const std::vector<WMIconHeader> headers = walkWMIconHeaders(property.reader());
+    QCOMPARE(headers.size(), size_t(1));
+    QCOMPARE(headers.front().width, 16u);
+}
+
+void WMIconTest::pick_data()
+{
+    QTest::addColumn<uint>("preferredSize");
+    QTest::addColumn<uint>("expected");
+
+    QTest::newRow("largest") << 0u << 512u;
+    QTest::newRow("exact") << 48u << 48u;
+    QTest::newRow("next larger") << 50u << 64u;
+    QTest::newRow("hidpi") << 96u << 128u;
+    QTest::newRow("all smaller") << 1024u << 512u;
+    QTest::newRow("smaller than all") << 8u << 16u;
+}
+
+/**
+ * @brief WMIconTest::pick 选取不小于目标尺寸的最小图标，都比目标小时取最大的，与属性中的顺序无关
+ */
+void WMIconTest::pick()
+{
+    QFETCH(uint, preferredSize);
+    QFETCH(uint, expected);
+
+    std::vector<WMIconHeader> headers;
+    for (uint32_t size : IconSizes)
+        headers.push_back(WMIconHeader{0, size, size});
+
+    QCOMPARE(pickWMIcon(headers, preferredSize).width, expected);
+
+    std::reverse(headers.begin(), headers.end());
+    QCOMPARE(pickWMIcon(headers, preferredSize).width, expected);
+}
+
+/**
+ * @brief WMIconTest::pickNonSquare 非正方形的图标按长边比较
+ */
+void WMIconTest::pickNonSquare()
+{
+    const std::vector<WMIconHeader> headers = {
+        WMIconHeader{0, 64, 16},
+        WMIconHeader{0, 40, 40},
+        WMIconHeader{0, 16, 128},
+    };
+
+    QCOMPARE(pickWMIcon(headers, 48).width, 64u);
+    QCOMPARE(pickWMIcon(headers, 100).height, 128u);
+    QCOMPARE(pickWMIcon(headers, 0).width, 40u);
+}
+
+/**
+ * @brief WMIconTest::transferredBytes 以48像素显示时，只读取头部与48像素的图标，对比下载整个属性
+ */
+void WMIconTest::transferredBytes()
+{
+    FakeProperty property;
+    for (uint32_t size : IconSizes)
+        property.append(size, size);
+
+    const std::vector<WMIconHeader> headers = walkWMIconHeaders(property.reader());
+    const WMIconHeader best = pickWMIcon(headers, 48);
+    QCOMPARE(property.pixels(best).size(), size_t(48 * 48));
+
+    const uint64_t expected = IconSizes.size() * 2 * sizeof(uint32_t) + 48 * 48 * sizeof(uint32_t);
+    QCOMPARE(property.transferredBytes(), expected);
+    qInfo() << "transferred" << property.transferredBytes() << "of" << property.totalBytes() << "bytes";
+}
+
+QTEST_MAIN(WMIconTest)
+
+#include "tst_wmicon.moc"